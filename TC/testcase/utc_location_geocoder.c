@@ -14,8 +14,12 @@
 * limitations under the License.
 */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include <tet_api.h>
 #include <location/geocoder.h>
+#include <location/location.h>
 #include <glib.h>
 
 
@@ -47,7 +51,42 @@ static void utc_location_geocoder_foreach_positions_from_address_n(void);
 static void utc_location_geocoder_foreach_positions_from_address_n_02(void);
 static void utc_location_geocoder_foreach_positions_from_address_n_03(void);
 static void utc_location_geocoder_foreach_positions_from_address_n_04(void);
+static void utc_location_geocoder_set_retry_policy_p(void);
+static void utc_location_geocoder_set_retry_policy_n(void);
+static void utc_location_geocoder_set_retry_policy_n_02(void);
 
+static void utc_location_geocoder_get_fd_p(void);
+static void utc_location_geocoder_get_fd_n(void);
+static void utc_location_geocoder_dispatch_p(void);
+static void utc_location_geocoder_dispatch_n(void);
+static void utc_location_geocoder_get_positions_from_address_p(void);
+static void utc_location_geocoder_get_positions_from_address_n(void);
+static void utc_location_geocoder_set_gazetteer_n(void);
+static void utc_location_geocoder_foreach_suggestions_n(void);
+static void utc_location_geocoder_foreach_nearby_addresses_n(void);
+static void utc_location_geocoder_foreach_nearby_addresses_n_02(void);
+static void utc_location_geocoder_set_boundary_data_n(void);
+static void utc_location_geocoder_get_region_from_position_n(void);
+static void utc_location_geocoder_get_region_from_position_n_02(void);
+static void utc_location_geocoder_set_shared_cache_p(void);
+static void utc_location_geocoder_set_shared_cache_n(void);
+static void utc_location_geocoder_set_trace_p(void);
+static void utc_location_geocoder_set_trace_n(void);
+static void utc_location_geocoder_set_dispatch_mode_p(void);
+static void utc_location_geocoder_set_dispatch_mode_n(void);
+static void utc_location_geocoder_set_callback_budget_n(void);
+static void utc_location_geocoder_get_callback_overruns_p(void);
+static void utc_location_geocoder_get_address_from_position_with_detail_p(void);
+static void utc_location_geocoder_get_address_from_position_with_detail_n(void);
+static void utc_location_geocoder_parse_address_p(void);
+static void utc_location_geocoder_parse_address_n(void);
+static void utc_location_geocoder_set_offline_tiles_n(void);
+static void utc_location_geocoder_set_offline_tile_budget_p(void);
+static void utc_location_geocoder_update_offline_tile_n(void);
+static void utc_location_geocoder_destroy_p_02(void);
+static void utc_location_geocoder_foreach_suggestions_p(void);
+static void utc_location_geocoder_foreach_nearby_addresses_p(void);
+static void utc_location_geocoder_get_region_from_position_p(void);
 
 
 struct tet_testlist tet_testlist[] = {
@@ -68,6 +107,41 @@ struct tet_testlist tet_testlist[] = {
 	{ utc_location_geocoder_foreach_positions_from_address_n_02, NEGATIVE_TC_IDX },
 	{ utc_location_geocoder_foreach_positions_from_address_n_03, NEGATIVE_TC_IDX },
 	{ utc_location_geocoder_foreach_positions_from_address_n_04, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_retry_policy_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_set_retry_policy_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_retry_policy_n_02, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_get_fd_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_get_fd_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_dispatch_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_dispatch_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_get_positions_from_address_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_get_positions_from_address_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_gazetteer_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_foreach_suggestions_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_foreach_nearby_addresses_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_foreach_nearby_addresses_n_02, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_boundary_data_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_get_region_from_position_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_get_region_from_position_n_02, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_shared_cache_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_set_shared_cache_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_trace_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_set_trace_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_dispatch_mode_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_set_dispatch_mode_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_callback_budget_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_get_callback_overruns_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_get_address_from_position_with_detail_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_get_address_from_position_with_detail_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_parse_address_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_parse_address_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_offline_tiles_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_set_offline_tile_budget_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_update_offline_tile_n, NEGATIVE_TC_IDX },
+	{ utc_location_geocoder_destroy_p_02, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_foreach_suggestions_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_foreach_nearby_addresses_p, POSITIVE_TC_IDX },
+	{ utc_location_geocoder_get_region_from_position_p, POSITIVE_TC_IDX },
 	{ NULL, 0 },
 };
 
@@ -441,7 +515,945 @@ static void utc_location_geocoder_foreach_positions_from_address_n_04(void)
 	dts_fail(api_name);
 }
 
+static void utc_location_geocoder_set_retry_policy_p(void)
+{
+	char* api_name = "geocoder_set_retry_policy";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_retry_policy(geocoder, 3, 100, 2000);
+		if(ret == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_retry_policy_n(void)
+{
+	char* api_name = "geocoder_set_retry_policy";
+	int ret;
+	if ((ret = geocoder_set_retry_policy(NULL, 3, 100, 2000)) != GEOCODER_ERROR_NONE)
+	{
+		dts_pass(api_name);
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_retry_policy_n_02(void)
+{
+	char* api_name = "geocoder_set_retry_policy";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_retry_policy(geocoder, 3, 2000, 100);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_fd_p(void)
+{
+	char* api_name = "geocoder_get_fd";
+	int ret;
+	int fd = -1;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_fd(geocoder, &fd);
+		if(ret == GEOCODER_ERROR_NONE && fd >= 0)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_fd_n(void)
+{
+	char* api_name = "geocoder_get_fd";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_fd(geocoder, NULL);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_dispatch_p(void)
+{
+	char* api_name = "geocoder_dispatch";
+	int ret;
+	int fd = -1;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		if ((ret = geocoder_get_fd(geocoder, &fd)) == GEOCODER_ERROR_NONE)
+		{
+			ret = geocoder_dispatch(geocoder, 0);
+			if(ret == GEOCODER_ERROR_NONE)
+			{
+				geocoder_destroy(geocoder);
+				dts_pass(api_name);
+			}
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_dispatch_n(void)
+{
+	char* api_name = "geocoder_dispatch";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_dispatch(geocoder, 0);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void get_positions_cb(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data)
+{
+	char* api_name = "geocoder_get_positions_from_address";
+	dts_message(api_name,"result:%d, count:%d\n", result, count);
+}
+
+static void utc_location_geocoder_get_positions_from_address_p(void)
+{
+	char* api_name = "geocoder_get_positions_from_address";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret = geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		char *address="suwon";
+		ret = geocoder_get_positions_from_address(geocoder, address, get_positions_cb, NULL);
+		if(ret == GEOCODER_ERROR_NONE)
+		{
+			g_timeout_add_seconds(60, _destroy_if_timeout, geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_positions_from_address_n(void)
+{
+	char* api_name = "geocoder_get_positions_from_address";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_positions_from_address(geocoder, NULL, get_positions_cb, NULL);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_gazetteer_n(void)
+{
+	char* api_name = "geocoder_set_gazetteer";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_gazetteer(geocoder, "/tmp/no_such_gazetteer.tsv");
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static bool suggestion_cb(geocoder_error_e result, const char *address, double latitude, double longitude, void *user_data)
+{
+	char* api_name = "geocoder_foreach_suggestions";
+	dts_message(api_name,"address:%s, latitude:%f, longitude:%f\n", address, latitude, longitude);
+	return true;
+}
+
+static void utc_location_geocoder_foreach_suggestions_n(void)
+{
+	char* api_name = "geocoder_foreach_suggestions";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_foreach_suggestions(geocoder, "suw", 0, suggestion_cb, NULL);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static bool nearby_address_cb(geocoder_error_e result, double distance, double latitude, double longitude, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	char* api_name = "geocoder_foreach_nearby_addresses";
+	dts_message(api_name,"distance: %f, street: %s, city: %s\n", distance, street, city);
+	return true;
+}
+
+static void utc_location_geocoder_foreach_nearby_addresses_n(void)
+{
+	char* api_name = "geocoder_foreach_nearby_addresses";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_foreach_nearby_addresses(geocoder, 37.258, 127.056, 0, 0, nearby_address_cb, NULL);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_foreach_nearby_addresses_n_02(void)
+{
+	char* api_name = "geocoder_foreach_nearby_addresses";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_foreach_nearby_addresses(geocoder, 37.258, 127.056, 8, 0, nearby_address_cb, NULL);
+		if(ret == GEOCODER_ERROR_SERVICE_NOT_AVAILABLE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_boundary_data_n(void)
+{
+	char* api_name = "geocoder_set_boundary_data";
+	int ret;
+
+	ret = geocoder_set_boundary_data(NULL, "/tmp/boundary.tsv");
+	if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		dts_pass(api_name);
+	dts_message(api_name, "Call log: %d", ret);
+	dts_fail(api_name);
+}
+
+static void region_cb(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	char* api_name = "geocoder_get_region_from_position";
+	dts_message(api_name,"city: %s, district: %s, state: %s, country_code: %s\n", city, district, state, country_code);
+}
+
+static void utc_location_geocoder_get_region_from_position_n(void)
+{
+	char* api_name = "geocoder_get_region_from_position";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_region_from_position(geocoder, 37.258, 127.056, region_cb, NULL);
+		if(ret == GEOCODER_ERROR_SERVICE_NOT_AVAILABLE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_region_from_position_n_02(void)
+{
+	char* api_name = "geocoder_get_region_from_position";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_region_from_position(geocoder, 100.0, 127.056, region_cb, NULL);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_shared_cache_p(void)
+{
+	char* api_name = "geocoder_set_shared_cache";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_shared_cache(geocoder, "geocoder-utc", 64 * 1024);
+		if(ret == GEOCODER_ERROR_NONE && geocoder_set_shared_cache(geocoder, NULL, 0) == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_shared_cache_n(void)
+{
+	char* api_name = "geocoder_set_shared_cache";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_shared_cache(geocoder, "geocoder-utc", 0);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_trace_p(void)
+{
+	char* api_name = "geocoder_set_trace";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_trace(geocoder, GEOCODER_TRACE_RECORD, "/tmp/geocoder_utc.trace");
+		if(ret == GEOCODER_ERROR_NONE && geocoder_set_trace(geocoder, GEOCODER_TRACE_REPLAY_FAST, "/tmp/geocoder_utc.trace") == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_trace_n(void)
+{
+	char* api_name = "geocoder_set_trace";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_trace(geocoder, GEOCODER_TRACE_REPLAY, NULL);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_dispatch_mode_p(void)
+{
+	char* api_name = "geocoder_set_dispatch_mode";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_dispatch_mode(geocoder, GEOCODER_DISPATCH_THREAD_POOL, NULL);
+		if(ret == GEOCODER_ERROR_NONE && geocoder_set_dispatch_mode(geocoder, GEOCODER_DISPATCH_INLINE, NULL) == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_dispatch_mode_n(void)
+{
+	char* api_name = "geocoder_set_dispatch_mode";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_dispatch_mode(geocoder, GEOCODER_DISPATCH_CONTEXT, NULL);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
 
+static void utc_location_geocoder_set_callback_budget_n(void)
+{
+	char* api_name = "geocoder_set_callback_budget";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_callback_budget(geocoder, -1);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_callback_overruns_p(void)
+{
+	char* api_name = "geocoder_get_callback_overruns";
+	int ret;
+	int count = -1;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		geocoder_set_callback_budget(geocoder, 50);
+		ret = geocoder_get_callback_overruns(geocoder, &count);
+		if(ret == GEOCODER_ERROR_NONE && count == 0)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_address_from_position_with_detail_p(void)
+{
+	char* api_name = "geocoder_get_address_from_position_with_detail";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_address_from_position_with_detail(geocoder,37.258,127.056,GEOCODER_DETAIL_CITY,get_address_cb,(void*)geocoder);
+		if(ret == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+		dts_message(api_name, "Ret : %d", ret);
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_get_address_from_position_with_detail_n(void)
+{
+	char* api_name = "geocoder_get_address_from_position_with_detail";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_get_address_from_position_with_detail(geocoder,37.258,127.056,99,get_address_cb,(void*)geocoder);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void parsed_address_cb(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	bool *parsed = (bool*)user_data;
+	dts_message("geocoder_parse_address", "building number: %s, postal code: %s, street: %s, city: %s, state: %s, country code: %s", building_number, postal_code, street, city, state, country_code);
+	*parsed = result == GEOCODER_ERROR_NONE && g_strcmp0(building_number, "1600") == 0 && g_strcmp0(street, "Pennsylvania Ave NW") == 0
+		&& g_strcmp0(city, "Washington") == 0 && g_strcmp0(state, "DC") == 0 && g_strcmp0(postal_code, "20500") == 0 && g_strcmp0(country_code, "US") == 0;
+}
+
+static void utc_location_geocoder_parse_address_p(void)
+{
+	char* api_name = "geocoder_parse_address";
+	bool parsed = false;
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		/* The callback is invoked before geocoder_parse_address() returns */
+		ret = geocoder_parse_address(geocoder, "1600 Pennsylvania Ave NW, Washington, DC 20500", parsed_address_cb, &parsed);
+		if(ret == GEOCODER_ERROR_NONE && parsed)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_parse_address_n(void)
+{
+	char* api_name = "geocoder_parse_address";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_parse_address(geocoder, NULL, get_address_cb, (void*)geocoder);
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_offline_tiles_n(void)
+{
+	char* api_name = "geocoder_set_offline_tiles";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_offline_tiles(geocoder, "/nonexistent/tiles");
+		if(ret == GEOCODER_ERROR_INVALID_PARAMETER)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_set_offline_tile_budget_p(void)
+{
+	char* api_name = "geocoder_set_offline_tile_budget";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_offline_tile_budget(geocoder, 4 * 1024 * 1024);
+		if(ret == GEOCODER_ERROR_NONE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void utc_location_geocoder_update_offline_tile_n(void)
+{
+	char* api_name = "geocoder_update_offline_tile";
+	int ret;
+	geocoder_h geocoder;
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_update_offline_tile(geocoder, "wydm", "/tmp/wydm.tile");
+		if(ret == GEOCODER_ERROR_SERVICE_NOT_AVAILABLE)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static void write_trace_address(FILE *file, gint32 error, guint32 latency, double latitude, double longitude)
+{
+	guint8 kind = 1;
+	guint16 none = 0xffff;
+	guint8 no_accuracy = 0xff;
+	int i;
+
+	fwrite(&kind, sizeof(kind), 1, file);
+	fwrite(&error, sizeof(error), 1, file);
+	fwrite(&latency, sizeof(latency), 1, file);
+	fwrite(&latitude, sizeof(latitude), 1, file);
+	fwrite(&longitude, sizeof(longitude), 1, file);
+	for(i = 0; i < 7; i++)
+		fwrite(&none, sizeof(none), 1, file);
+	fwrite(&no_accuracy, sizeof(no_accuracy), 1, file);
+}
+
+static void count_address_cb(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	g_atomic_int_inc((gint*)user_data);
+}
+
+static void utc_location_geocoder_destroy_p_02(void)
+{
+	char* api_name = "geocoder_destroy";
+	const char *path = "/tmp/geocoder_utc_breaker.trace";
+	guint32 version = 2;
+	gint answered = 0;
+	int ret;
+	int i;
+	geocoder_h geocoder;
+	FILE *file = fopen(path, "wb");
+	if(file != NULL)
+	{
+		/* A failing position, and one whose answer takes a minute */
+		fwrite("GEOT", 1, 4, file);
+		fwrite(&version, sizeof(version), 1, file);
+		write_trace_address(file, LOCATION_ERROR_NETWORK_FAILED, 0, 37.0, 127.0);
+		write_trace_address(file, LOCATION_ERROR_NONE, 60000, 38.0, 127.0);
+		fclose(file);
+	}
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		geocoder_set_retry_policy(geocoder, 0, 1, 1);
+		geocoder_set_trace(geocoder, GEOCODER_TRACE_REPLAY, path);
+		/* Five failures in a row open the provider's circuit, which lets one probe through after 30 seconds */
+		for(i = 0; i < 5; i++)
+			geocoder_get_address_from_position(geocoder, 37.0, 127.0, count_address_cb, &answered);
+		for(i = 0; i < 50 && g_atomic_int_get(&answered) < 5; i++)
+			g_usleep(100 * 1000);
+		g_usleep(31 * G_USEC_PER_SEC);
+		ret = geocoder_get_address_from_position(geocoder, 38.0, 127.0, get_address_cb, NULL);
+		/* The probe is still in flight, its slot must go with the handle */
+		geocoder_destroy(geocoder);
+		if(ret == GEOCODER_ERROR_NONE && (ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+		{
+			geocoder_set_trace(geocoder, GEOCODER_TRACE_REPLAY, path);
+			ret = geocoder_get_address_from_position(geocoder, 38.0, 127.0, get_address_cb, NULL);
+			if(ret == GEOCODER_ERROR_NONE)
+			{
+				geocoder_destroy(geocoder);
+				dts_pass(api_name);
+			}
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+static bool collect_suggestion_cb(geocoder_error_e result, const char *address, double latitude, double longitude, void *user_data)
+{
+	GArray *latitudes = (GArray*)user_data;
+	if(result == GEOCODER_ERROR_NONE)
+		g_array_append_val(latitudes, latitude);
+	return true;
+}
+
+static void utc_location_geocoder_foreach_suggestions_p(void)
+{
+	char* api_name = "geocoder_foreach_suggestions";
+	const char *path = "/tmp/geocoder_utc_gazetteer.tsv";
+	GArray *latitudes = g_array_new(FALSE, FALSE, sizeof(double));
+	int ret;
+	int i;
+	geocoder_h geocoder;
+	FILE *file = fopen(path, "w");
+	if(file != NULL)
+	{
+		/* More entries of the same name than a block holds, the latitude doubling as the weight */
+		fprintf(file, "Anyang\t1.0\t127.0\t1000\n");
+		for(i = 0; i < 40; i++)
+			fprintf(file, "Suwon\t%d.0\t127.0\t%d\n", i, i);
+		fprintf(file, "Yongin\t2.0\t127.0\t1000\n");
+		fclose(file);
+	}
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_gazetteer(geocoder, path);
+		if(ret == GEOCODER_ERROR_NONE)
+			ret = geocoder_foreach_suggestions(geocoder, "suwon", 3, collect_suggestion_cb, latitudes);
+		if(ret == GEOCODER_ERROR_NONE && latitudes->len == 3
+			&& g_array_index(latitudes, double, 0) == 39.0
+			&& g_array_index(latitudes, double, 1) == 38.0
+			&& g_array_index(latitudes, double, 2) == 37.0)
+		{
+			g_array_free(latitudes, TRUE);
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d, %d suggestions", ret, latitudes->len);
+	g_array_free(latitudes, TRUE);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+#define NEARBY_FIXTURE_COUNT	300
+
+typedef struct {
+	double distance;
+	int index;
+}nearby_found_s;
+
+static bool collect_nearby_cb(geocoder_error_e result, double distance, double latitude, double longitude, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	nearby_found_s found = { distance, building_number != NULL ? atoi(building_number) : -1 };
+	g_array_append_val((GArray*)user_data, found);
+	return true;
+}
+
+static double nearby_distance(double latitude1, double longitude1, double latitude2, double longitude2)
+{
+	double dlat = (latitude2 - latitude1) * G_PI / 180.0;
+	double dlon = (longitude2 - longitude1) * G_PI / 180.0;
+	double a = sin(dlat / 2) * sin(dlat / 2) + cos(latitude1 * G_PI / 180.0) * cos(latitude2 * G_PI / 180.0) * sin(dlon / 2) * sin(dlon / 2);
+	return 2.0 * 6371008.8 * asin(MIN(sqrt(a), 1.0));
+}
 
+static int compare_nearby(const void *a, const void *b)
+{
+	double diff = ((const nearby_found_s*)a)->distance - ((const nearby_found_s*)b)->distance;
+	return diff < 0 ? -1 : diff > 0 ? 1 : 0;
+}
+
+/* The lookup must give what sorting every fixture address by distance gives */
+static bool check_nearby(geocoder_h geocoder, const double *latitudes, const double *longitudes, double latitude, double longitude, int max_count, double radius)
+{
+	nearby_found_s all[NEARBY_FIXTURE_COUNT];
+	GArray *found = g_array_new(FALSE, FALSE, sizeof(nearby_found_s));
+	guint expected;
+	bool ok;
+	int i;
+
+	for(i = 0; i < NEARBY_FIXTURE_COUNT; i++)
+	{
+		all[i].distance = nearby_distance(latitude, longitude, latitudes[i], longitudes[i]);
+		all[i].index = i;
+	}
+	qsort(all, NEARBY_FIXTURE_COUNT, sizeof(nearby_found_s), compare_nearby);
+	for(expected = 0; expected < NEARBY_FIXTURE_COUNT; expected++)
+	{
+		if((max_count > 0 && expected >= max_count) || (radius > 0 && all[expected].distance > radius))
+			break;
+	}
+
+	ok = geocoder_foreach_nearby_addresses(geocoder, latitude, longitude, max_count, radius, collect_nearby_cb, found) == GEOCODER_ERROR_NONE
+		&& expected > 0 && found->len == expected;
+	for(i = 0; ok && i < expected; i++)
+	{
+		nearby_found_s *result = &g_array_index(found, nearby_found_s, i);
+		ok = result->index == all[i].index && fabs(result->distance - all[i].distance) < 0.01;
+	}
+	g_array_free(found, TRUE);
+	return ok;
+}
+
+static void utc_location_geocoder_foreach_nearby_addresses_p(void)
+{
+	char* api_name = "geocoder_foreach_nearby_addresses";
+	const char *path = "/tmp/geocoder_utc_offline.tsv";
+	double latitudes[NEARBY_FIXTURE_COUNT];
+	double longitudes[NEARBY_FIXTURE_COUNT];
+	GRand *rand = g_rand_new_with_seed(31);
+	int ret;
+	int i;
+	geocoder_h geocoder;
+	FILE *file = fopen(path, "w");
+	for(i = 0; i < NEARBY_FIXTURE_COUNT; i++)
+	{
+		/* Around Suwon, then around Fiji on both sides of the antimeridian */
+		if(i < 200)
+		{
+			latitudes[i] = 37.0 + g_rand_int_range(rand, 0, 100000) * 0.00001;
+			longitudes[i] = 126.5 + g_rand_int_range(rand, 0, 100000) * 0.00001;
+		}
+		else
+		{
+			latitudes[i] = -17.0 + g_rand_int_range(rand, 0, 100000) * 0.00001;
+			longitudes[i] = 179.5 + g_rand_int_range(rand, 0, 100000) * 0.00001;
+			if(longitudes[i] > 180.0)
+				longitudes[i] -= 360.0;
+		}
+		if(file != NULL)
+			fprintf(file, "%.5f\t%.5f\t%d\t\tstreet\tcity\t\tstate\tKR\n", latitudes[i], longitudes[i], i);
+	}
+	g_rand_free(rand);
+	if(file != NULL)
+		fclose(file);
+
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_offline_data(geocoder, path);
+		if(ret == GEOCODER_ERROR_NONE
+			&& check_nearby(geocoder, latitudes, longitudes, 37.5, 127.0, 10, 0)
+			&& check_nearby(geocoder, latitudes, longitudes, 37.5, 127.0, 0, 20000)
+			&& check_nearby(geocoder, latitudes, longitudes, 37.5, 127.0, 5, 10000)
+			&& check_nearby(geocoder, latitudes, longitudes, -16.5, 179.99, 10, 0)
+			&& check_nearby(geocoder, latitudes, longitudes, -16.5, -179.99, 0, 30000))
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
+
+typedef struct {
+	char city[32];
+	char district[32];
+	char state[32];
+	char country_code[32];
+}region_names_s;
+
+static void collect_region_cb(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	region_names_s *names = (region_names_s*)user_data;
+	g_strlcpy(names->city, city != NULL ? city : "", sizeof(names->city));
+	g_strlcpy(names->district, district != NULL ? district : "", sizeof(names->district));
+	g_strlcpy(names->state, state != NULL ? state : "", sizeof(names->state));
+	g_strlcpy(names->country_code, country_code != NULL ? country_code : "", sizeof(names->country_code));
+}
+
+/* Empty strings stand for levels where no polygon holds the position */
+static bool check_region(geocoder_h geocoder, double latitude, double longitude, const char *district, const char *city, const char *state)
+{
+	region_names_s names;
+	if(geocoder_get_region_from_position(geocoder, latitude, longitude, collect_region_cb, &names) != GEOCODER_ERROR_NONE)
+		return false;
+	if(g_strcmp0(names.district, district) != 0 || g_strcmp0(names.city, city) != 0 || g_strcmp0(names.state, state) != 0 || g_strcmp0(names.country_code, "KR") != 0)
+	{
+		dts_message("geocoder_get_region_from_position", "%f %f : %s/%s/%s, expected %s/%s/%s", latitude, longitude, names.district, names.city, names.state, district, city, state);
+		return false;
+	}
+	return true;
+}
 
+static void utc_location_geocoder_get_region_from_position_p(void)
+{
+	char* api_name = "geocoder_get_region_from_position";
+	const char *path = "/tmp/geocoder_utc_boundary.tsv";
+	char district[32];
+	bool ok;
+	int ret;
+	int i;
+	int j;
+	geocoder_h geocoder;
+	FILE *file = fopen(path, "w");
+	if(file != NULL)
+	{
+		fprintf(file, "country\tKR\t126 37,128 37,128 38,126 38\n");
+		fprintf(file, "state\tGG\t126 37,127 37,127 38,126 38\n");
+		fprintf(file, "state\tCB\t127 37,127 38,128 38,128 37\n");
+		/* A ring band : the hole is not part of the city */
+		fprintf(file, "city\tSuwon\t126.25 37.25,126.75 37.25,126.75 37.75,126.25 37.75;126.4375 37.4375,126.5625 37.4375,126.5625 37.5625,126.4375 37.5625\n");
+		/* 256 districts of 1/16 degree, enough for three levels of R-tree, with six edges each and alternate orientations */
+		for(i = 0; i < 16; i++)
+		{
+			for(j = 0; j < 16; j++)
+			{
+				double x0 = 126.0 + i / 16.0, x1 = x0 + 1 / 16.0, xm = x0 + 1 / 32.0;
+				double y0 = 37.0 + j / 16.0, y1 = y0 + 1 / 16.0, ym = y0 + 1 / 32.0;
+				if((i + j) % 2 == 0)
+					fprintf(file, "district\tD%d_%d\t%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f\n", i, j, x0, y0, xm, y0, x1, y0, x1, y1, x0, y1, x0, ym);
+				else
+					fprintf(file, "district\tD%d_%d\t%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f,%.5f %.5f\n", i, j, x0, y0, x0, ym, x0, y1, x1, y1, x1, y0, xm, y0);
+			}
+		}
+		fclose(file);
+	}
 
+	if ((ret =geocoder_create(&geocoder)) == GEOCODER_ERROR_NONE)
+	{
+		ret = geocoder_set_boundary_data(geocoder, path);
+		ok = (ret == GEOCODER_ERROR_NONE);
+		for(i = 0; ok && i < 16; i++)
+		{
+			for(j = 0; ok && j < 16; j++)
+			{
+				double x = 126.0 + i / 16.0, y = 37.0 + j / 16.0;
+				bool suwon = (i >= 4 && i < 12 && j >= 4 && j < 12) && !(i >= 7 && i < 9 && j >= 7 && j < 9);
+				snprintf(district, sizeof(district), "D%d_%d", i, j);
+				/* Inside, on the west edge, and on the south-west vertex : edges and vertices belong to the polygon to the east and north */
+				ok = check_region(geocoder, y + 1 / 64.0, x + 1 / 64.0, district, suwon ? "Suwon" : "", "GG")
+					&& check_region(geocoder, y + 1 / 64.0, x, district, suwon ? "Suwon" : "", "GG")
+					&& check_region(geocoder, y, x, district, suwon ? "Suwon" : "", "GG");
+			}
+		}
+		/* The border between the states, on an edge and on a vertex of the east one */
+		ok = ok && check_region(geocoder, 37.5, 127.0, "", "", "CB") && check_region(geocoder, 37.0, 127.0, "", "", "CB");
+		if(ok)
+		{
+			geocoder_destroy(geocoder);
+			dts_pass(api_name);
+		}
+	}
+	dts_message(api_name, "Call log: %d", ret);
+	geocoder_destroy(geocoder);
+	dts_fail(api_name);
+}
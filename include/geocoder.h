@@ -48,8 +48,42 @@ typedef enum
     GEOCODER_ERROR_NETWORK_FAILED = TIZEN_ERROR_LOCATION_CLASS | 0x02,			/**< Network unavailable*/
     GEOCODER_ERROR_SERVICE_NOT_AVAILABLE = TIZEN_ERROR_LOCATION_CLASS | 0x03,	/**< Service unavailable */
     GEOCODER_ERROR_NOT_FOUND = TIZEN_ERROR_LOCATION_CLASS | 0x04,	/**< Result not found */
+    GEOCODER_ERROR_INVALID_OPERATION = TIZEN_ERROR_INVALID_OPERATION,	/**< Called from a callback of the thread pool */
 } geocoder_error_e;
 
+/**
+ * @brief Enumerations of the backend trace modes
+ */
+typedef enum
+{
+    GEOCODER_TRACE_NONE,			/**< Requests go to the map provider */
+    GEOCODER_TRACE_RECORD,			/**< Requests go to the map provider, and the provider's responses are written to the trace */
+    GEOCODER_TRACE_REPLAY,			/**< Responses come from the trace, after the latency recorded with them */
+    GEOCODER_TRACE_REPLAY_FAST,		/**< Responses come from the trace, as soon as possible */
+} geocoder_trace_mode_e;
+
+/**
+ * @brief Enumerations of the levels of detail of an address
+ */
+typedef enum
+{
+    GEOCODER_DETAIL_COUNTRY,		/**< The country code only */
+    GEOCODER_DETAIL_REGION,		/**< The country code and the state */
+    GEOCODER_DETAIL_CITY,			/**< The country code, the state, the city and the district */
+    GEOCODER_DETAIL_STREET,		/**< The full address, from the map provider */
+    GEOCODER_DETAIL_NEARBY_STREET,	/**< The full address of the nearest offline tile address within 100 m, from the map provider when there is none */
+} geocoder_detail_level_e;
+
+/**
+ * @brief Enumerations of the contexts where result callbacks are invoked
+ */
+typedef enum
+{
+    GEOCODER_DISPATCH_INLINE,			/**< In the context where the map provider answers, usually the default main context */
+    GEOCODER_DISPATCH_CONTEXT,			/**< In a main context given by the application */
+    GEOCODER_DISPATCH_THREAD_POOL,		/**< In a pool of threads owned by the geocoder handle */
+} geocoder_dispatch_mode_e;
+
 /**
  * @brief	Called once for each position information converted from the given address information.
  * @param[in] result The result of request
@@ -63,6 +97,32 @@ typedef enum
 typedef bool(*geocoder_get_position_cb)(geocoder_error_e result, double latitude, double longitude, void *user_data);
 
 
+/**
+ * @brief	Called once with all position information converted from the given address information.
+ * @remarks You should not free the arrays, they are valid only in the callback.
+ * @param[in] result The result of request
+ * @param[in] count The number of positions
+ * @param[in] latitudes The latitudes [-90.0 ~ 90.0] (degrees), @a count elements
+ * @param[in] longitudes The longitudes [-180.0 ~ 180.0] (degrees), @a count elements
+ * @param[in] user_data The user data passed from the request function
+ * @pre geocoder_get_positions_from_address() will invoke this callback.
+ * @see geocoder_get_positions_from_address()
+ */
+typedef void (*geocoder_get_positions_cb)(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data);
+
+/**
+ * @brief	Called once for each address suggested for a partial address.
+ * @param[in] result The result of request
+ * @param[in] address The suggested address
+ * @param[in] latitude The latitude [-90.0 ~ 90.0] (degrees)
+ * @param[in] longitude The longitude [-180.0 ~ 180.0] (degrees)
+ * @param[in] user_data The user data passed from the foreach function
+ * @return @c true to continue with the next iteration of the loop, \n @c false to break out of the loop
+ * @pre geocoder_foreach_suggestions() will invoke this callback.
+ * @see geocoder_foreach_suggestions()
+ */
+typedef bool (*geocoder_suggestion_cb)(geocoder_error_e result, const char *address, double latitude, double longitude, void *user_data);
+
 /**
  * @brief   Called when the address information has converted from position information.
  * @remarks You should not free all string values.
@@ -80,6 +140,27 @@ typedef bool(*geocoder_get_position_cb)(geocoder_error_e result, double latitude
  */
 typedef void (*geocoder_get_address_cb)(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data);
 
+/**
+ * @brief   Called once for each address found near a position, nearest first.
+ * @remarks You should not free all string values.
+ * @param[in] result The result of request
+ * @param[in] distance The distance from the requested position (meters)
+ * @param[in] latitude The latitude of the address [-90.0 ~ 90.0] (degrees)
+ * @param[in] longitude The longitude of the address [-180.0 ~ 180.0] (degrees)
+ * @param[in] building_number	 The building number
+ * @param[in] postal_code	The postal delivery code
+ * @param[in] street	The full street name
+ * @param[in] city	The city name
+ * @param[in] district	The municipal district name
+ * @param[in] state	The state or province region of a nation
+ * @param[in] country_code	The country code
+ * @param[in] user_data The user data passed from the foreach function
+ * @return @c true to continue with the next iteration of the loop, \n @c false to break out of the loop
+ * @pre geocoder_foreach_nearby_addresses() will invoke this callback.
+ * @see	geocoder_foreach_nearby_addresses()
+ */
+typedef bool (*geocoder_nearby_address_cb)(geocoder_error_e result, double distance, double latitude, double longitude, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data);
+
 /**
  * @brief Creates a new geocoder handle.
  * @details
@@ -97,6 +178,7 @@ int geocoder_create(geocoder_h *geocoder);
 
 /**
  * @brief	Destroys the geocoder handle and releases all its resources.
+ * @remarks The callbacks of requests still pending are not invoked once this function returns.
  * @param   [in] geocoder	The geocoder handle to destroy
  * @return  0 on success, otherwise a negative error value.
  * @retval #GEOCODER_ERROR_NONE Successful
@@ -105,9 +187,29 @@ int geocoder_create(geocoder_h *geocoder);
  */
 int geocoder_destroy(geocoder_h geocoder);
 
+/**
+ * @brief Sets the retry policy for transient errors of the geocoder handle.
+ * @details
+ * A request which fails with #GEOCODER_ERROR_NETWORK_FAILED is issued again after an exponential backoff with random jitter,
+ * starting at @a base_delay and doubling up to @a max_delay for each attempt. The callback is only invoked once, with the result of the last attempt.
+ * @remarks Retries are also limited by a retry budget, so that at most one request in ten is retried while the provider keeps failing. \n
+ * By default, 2 retries are made with a base delay of 200 msec and a maximum delay of 5000 msec.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] max_retries The maximum number of retries per request, 0 to disable retries
+ * @param[in] base_delay The delay before the first retry (msec)
+ * @param[in] max_delay The upper bound of the delay between retries (msec)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_get_address_from_position()
+ * @see geocoder_foreach_positions_from_address()
+ */
+int geocoder_set_retry_policy(geocoder_h geocoder, int max_retries, int base_delay, int max_delay);
+
 /**
  * @brief Gets the address for a given position, asynchronously.
- * @remarks This function requires network access.
+ * @remarks This function requires network access. \n
+ * While the map provider keeps failing, requests fail immediately with #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE until the provider recovers.
  * @param[in] geocoder The geocoder handle
  * @param[in] latitude The latitude [-90.0 ~ 90.0] (degrees)
  * @param[in] longitude The longitude [-180.0 ~ 180.0] (degrees)
@@ -124,10 +226,38 @@ int geocoder_destroy(geocoder_h geocoder);
  */
 int geocoder_get_address_from_position(geocoder_h geocoder, double latitude, double longitude, geocoder_get_address_cb callback, void *user_data);
 
+/**
+ * @brief Gets the address for a given position down to a level of detail, asynchronously.
+ * @details
+ * Coarser levels than #GEOCODER_DETAIL_STREET are answered from the boundary data, without the map provider, when it covers the position at every level asked for.
+ * Only the values of the levels asked for are then passed to the callback, the others are NULL; the district may be NULL at #GEOCODER_DETAIL_CITY.
+ * At #GEOCODER_DETAIL_NEARBY_STREET, when offline tiles are set and one of their addresses lies within 100 m of the position,
+ * the nearest one is passed to the callback without the map provider. It may differ from the address the map provider would give.
+ * Otherwise, the request is answered as geocoder_get_address_from_position() does, and the full address is passed to the callback.
+ * @remarks The map provider requires network access.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] latitude The latitude [-90.0 ~ 90.0] (degrees)
+ * @param[in] longitude The longitude [-180.0 ~ 180.0] (degrees)
+ * @param[in] level The level of detail needed
+ * @param[in] callback The callback which will receive address information
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NETWORK_FAILED	Network connection failed
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE Service not available
+ * @post This function invokes geocoder_get_address_cb().
+ * @see	geocoder_get_address_from_position()
+ * @see geocoder_set_boundary_data()
+ * @see geocoder_set_offline_tiles()
+ */
+int geocoder_get_address_from_position_with_detail(geocoder_h geocoder, double latitude, double longitude, geocoder_detail_level_e level, geocoder_get_address_cb callback, void *user_data);
+
 /**
  * @brief Gets the positions for a given address, asynchronously.
  * @details This function gets positions for a given free-formed address string.
- * @remarks This function requires network access.
+ * @remarks This function requires network access. \n
+ * While the map provider keeps failing, requests fail immediately with #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE until the provider recovers.
  * @param[in] geocoder  The geocoder handle
  * @param[in] address	The free-formed address
  * @param[in] callback	The geocoder get positions callback function
@@ -143,6 +273,350 @@ int geocoder_get_address_from_position(geocoder_h geocoder, double latitude, dou
  */
 int geocoder_foreach_positions_from_address(geocoder_h geocoder, const char *address, geocoder_get_position_cb callback, void *user_data);
 
+/**
+ * @brief Gets all positions for a given address at once, asynchronously.
+ * @details This function is the same as geocoder_foreach_positions_from_address(), except that the callback is invoked once with every position,
+ * so the caller knows when the request is complete.
+ * @remarks This function requires network access.
+ * @param[in] geocoder  The geocoder handle
+ * @param[in] address	The free-formed address
+ * @param[in] callback	The callback which will receive the positions
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NETWORK_FAILED	Network connection failed
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE Service not available
+ * @post It invokes geocoder_get_positions_cb() once.
+ * @see	geocoder_get_positions_cb()
+ * @see geocoder_foreach_positions_from_address()
+ */
+int geocoder_get_positions_from_address(geocoder_h geocoder, const char *address, geocoder_get_positions_cb callback, void *user_data);
+
+/**
+ * @brief Loads a gazetteer used to suggest addresses locally.
+ * @details
+ * The gazetteer is a UTF-8 text file with one entry per line : the address, its latitude, its longitude and an optional weight, separated by tabs.
+ * Lines starting with '#' are ignored. Suggestions with a higher weight come first.
+ * @remarks A previously loaded gazetteer is released. Set @a path to NULL to release the gazetteer only.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] path The path of the gazetteer file
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_foreach_suggestions()
+ */
+int geocoder_set_gazetteer(geocoder_h geocoder, const char *path);
+
+/**
+ * @brief Gets the addresses starting with a given partial address, highest weight first.
+ * @details
+ * Suggestions are looked up in the gazetteer and the callback is invoked synchronously, before this function returns.
+ * Matching ignores case and Unicode normalization differences.
+ * If the gazetteer has no match, or none is loaded, the partial address is sent to the map provider as a free-formed address
+ * and the callback is invoked asynchronously with the partial address and each position found.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] prefix The partial address
+ * @param[in] max_count The maximum number of suggestions
+ * @param[in] callback The callback which will receive the suggestions
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NETWORK_FAILED	Network connection failed
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE Service not available
+ * @post It invokes geocoder_suggestion_cb() for each suggestion.
+ * @see geocoder_set_gazetteer()
+ * @see geocoder_suggestion_cb()
+ */
+int geocoder_foreach_suggestions(geocoder_h geocoder, const char *prefix, int max_count, geocoder_suggestion_cb callback, void *user_data);
+
+/**
+ * @brief Loads offline address data used to find nearby addresses.
+ * @details
+ * The data is a UTF-8 text file with one address per line : latitude, longitude, building number, postal code, street, city, district, state
+ * and country code, separated by tabs. Fields may be empty. Lines starting with '#' are ignored.
+ * @remarks Previously loaded data is released. Set @a path to NULL to release the data only.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] path The path of the address data file
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_foreach_nearby_addresses()
+ */
+int geocoder_set_offline_data(geocoder_h geocoder, const char *path);
+
+/**
+ * @brief Gets the addresses nearest to a given position, sorted by distance.
+ * @details
+ * Gets the @a max_count nearest addresses, or every address within @a radius, or the @a max_count nearest addresses within @a radius
+ * when both are given. The addresses are looked up in the offline data and the callback is invoked synchronously, before this function returns.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] latitude The latitude [-90.0 ~ 90.0] (degrees)
+ * @param[in] longitude The longitude [-180.0 ~ 180.0] (degrees)
+ * @param[in] max_count The maximum number of addresses, 0 for no limit
+ * @param[in] radius The search radius (meters), 0 for no limit
+ * @param[in] callback The callback which will receive the addresses
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NOT_FOUND	No address matches
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE No offline data is loaded
+ * @pre geocoder_set_offline_data() or geocoder_set_offline_tiles() must be called before.
+ * @post It invokes geocoder_nearby_address_cb() for each address.
+ * @see geocoder_set_offline_data()
+ * @see geocoder_set_offline_tiles()
+ * @see geocoder_nearby_address_cb()
+ */
+int geocoder_foreach_nearby_addresses(geocoder_h geocoder, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data);
+
+/**
+ * @brief Sets a directory of offline address tiles, mapped into memory as lookups need them.
+ * @details
+ * Each tile holds the addresses of one geohash cell of 4 characters, about 39 km by 20 km, in a file named after the geohash with the ".tile" extension.
+ * Tiles are written by geocoder_export_offline_tiles(). Nothing is read when the directory is set, and geocoder_foreach_nearby_addresses()
+ * maps only the tiles within its search radius. Tiles beyond the budget set with geocoder_set_offline_tile_budget() are unmapped, least recently used first.
+ * @remarks When set, the tiles are used instead of the data loaded with geocoder_set_offline_data(). Searches in tiles reach at most 100 km,
+ * also when @a radius is 0 or larger. \n
+ * geocoder_get_address_from_position_with_detail() also answers from the tiles at #GEOCODER_DETAIL_NEARBY_STREET,
+ * when they hold an address within 100 m of the position. \n
+ * Previously set tiles are released. Set @a directory to NULL to release the tiles only.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] directory The directory of the tiles
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_foreach_nearby_addresses()
+ * @see geocoder_update_offline_tile()
+ */
+int geocoder_set_offline_tiles(geocoder_h geocoder, const char *directory);
+
+/**
+ * @brief Sets how much of the offline tiles may stay mapped into memory.
+ * @details
+ * After each lookup, the least recently used tiles are unmapped until the size of the mapped tiles fits @a size.
+ * The tiles a lookup needs are mapped for it, even beyond the budget. The default budget is 16 MB.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] size The size of the mapped tiles (bytes)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_set_offline_tiles()
+ */
+int geocoder_set_offline_tile_budget(geocoder_h geocoder, int size);
+
+/**
+ * @brief Replaces one offline tile, without reloading the others.
+ * @details
+ * The file at @a path is checked, then moved into the tile directory under the name of @a tile, and the next lookups use it.
+ * @remarks @a path must be on the same file system as the tile directory. Lookups never see a partly written tile.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] tile The geohash of the tile, 4 characters
+ * @param[in] path The path of the new tile file
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter, or @a path is not a valid tile
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE No tile directory is set
+ * @pre geocoder_set_offline_tiles() must be called before.
+ * @see geocoder_set_offline_tiles()
+ */
+int geocoder_update_offline_tile(geocoder_h geocoder, const char *tile, const char *path);
+
+/**
+ * @brief Writes the offline data as tiles.
+ * @details
+ * The addresses loaded with geocoder_set_offline_data() are split by geohash cell and written into @a directory, one tile per cell holding addresses.
+ * Existing tiles of the same cells are replaced. The directory is created if needed.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] directory The directory of the tiles
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter, or the tiles cannot be written
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE No offline data is loaded
+ * @pre geocoder_set_offline_data() must be called before.
+ * @see geocoder_set_offline_tiles()
+ */
+int geocoder_export_offline_tiles(geocoder_h geocoder, const char *directory);
+
+/**
+ * @brief Loads administrative boundaries used to find the region of a position offline.
+ * @details
+ * The data is a UTF-8 text file with one polygon per line : the level ("country", "state", "city" or "district"), the name and the rings, separated by tabs.
+ * For the country level, the name is the country code. A ring is a list of "longitude latitude" vertices separated by ',', and rings are separated by ';'.
+ * Points inside an odd number of rings are inside the polygon, so inner rings are holes. Lines starting with '#' are ignored.
+ * @remarks Polygons must not cross the 180th meridian. Vertices are kept in single precision, about a meter. \n
+ * Previously loaded boundaries are released. Set @a path to NULL to release the boundaries only.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] path The path of the boundary data file
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_get_region_from_position()
+ */
+int geocoder_set_boundary_data(geocoder_h geocoder, const char *path);
+
+/**
+ * @brief Gets the administrative regions of a given position from the boundary data.
+ * @details
+ * Only the city, district, state and country code are filled, the other values are NULL.
+ * The callback is invoked synchronously, before this function returns, and the map provider is not used.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] latitude The latitude [-90.0 ~ 90.0] (degrees)
+ * @param[in] longitude The longitude [-180.0 ~ 180.0] (degrees)
+ * @param[in] callback The callback which will receive the region information
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NOT_FOUND	The position is not in any region
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE No boundary data is loaded
+ * @pre geocoder_set_boundary_data() must be called before.
+ * @post This function invokes geocoder_get_address_cb().
+ * @see geocoder_set_boundary_data()
+ * @see geocoder_get_address_from_position()
+ */
+int geocoder_get_region_from_position(geocoder_h geocoder, double latitude, double longitude, geocoder_get_address_cb callback, void *user_data);
+
+/**
+ * @brief Splits a freeform address into its components.
+ * @details
+ * The address is matched against the address formats of the supported countries : US, GB, DE, FR and KR.
+ * It is parsed only when it matches exactly one format as a whole; the country code is then that of the format, and components the format lacks are NULL.
+ * geocoder_foreach_positions_from_address() and geocoder_get_positions_from_address() send parsed addresses to the map provider as structured queries,
+ * and the others, or parsed addresses the provider does not find, as freeform text.
+ * The callback is invoked synchronously, before this function returns, and the map provider is not used.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] address The freeform address
+ * @param[in] callback The callback which will receive the address components
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_NOT_FOUND	The address matches no format, or several
+ * @post This function invokes geocoder_get_address_cb().
+ * @see geocoder_foreach_positions_from_address()
+ */
+int geocoder_parse_address(geocoder_h geocoder, const char *address, geocoder_get_address_cb callback, void *user_data);
+
+/**
+ * @brief Shares the results of the map provider with other processes through a named cache.
+ * @details
+ * Every process that sets the same @a name uses the same cache, kept in POSIX shared memory.
+ * geocoder_get_address_from_position(), geocoder_foreach_positions_from_address() and geocoder_get_positions_from_address() are answered
+ * from the cache when possible, still asynchronously, and the results of the map provider are added to it.
+ * Positions are matched to the microdegree and addresses regardless of case. Entries expire after a day.
+ * @remarks The process creating the cache decides its size; @a size is ignored when the cache already exists. \n
+ * The cache is created readable and writable by its owner only, so it is shared between processes of the same user. Any of them can read and change its entries. \n
+ * Set @a name to NULL to stop using the cache.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] name The name of the cache, without '/' but for an optional leading one
+ * @param[in] size The maximum size of the cache in bytes, which holds one entry per 512 bytes and at least 16 entries
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE	The cache cannot be opened
+ */
+int geocoder_set_shared_cache(geocoder_h geocoder, const char *name, int size);
+
+/**
+ * @brief Records the traffic with the map provider to a trace, or replays a trace in place of the map provider.
+ * @details
+ * In #GEOCODER_TRACE_RECORD mode, every request to the map provider, its response and its latency are written to a binary trace at @a path, retries included.
+ * In the replay modes, requests are answered from the trace at @a path instead : a request gets the responses recorded for the same position or
+ * the same address, in recording order, and the last one again when they run out. Requests not in the trace fail with #GEOCODER_ERROR_NOT_FOUND.
+ * @remarks Traces are written in the byte order of the recording device. \n
+ * Requests answered by the shared cache never reach the map provider, so they are neither recorded nor replayed. \n
+ * Only the latency of each response is reproduced, not the times at which the requests were issued while recording. \n
+ * Responses still waiting for their recorded latency are delivered at once when the trace is changed.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] mode The trace mode
+ * @param[in] path The path of the trace, ignored with #GEOCODER_TRACE_NONE
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_set_shared_cache()
+ */
+int geocoder_set_trace(geocoder_h geocoder, geocoder_trace_mode_e mode, const char *path);
+
+/**
+ * @brief Gets a file descriptor which becomes readable when results of the geocoder handle are ready.
+ * @details
+ * Once this function is called, callbacks of the geocoder handle are no longer invoked from the main loop of the location service.
+ * Their results are queued instead, and the file descriptor is signalled so that an application running its own event loop (e.g. epoll) can wait for it
+ * and invoke the callbacks with geocoder_dispatch() from its own thread.
+ * @remarks The file descriptor is owned by the geocoder handle and closed by geocoder_destroy(). You should not read from or close it. \n
+ * That thread may also issue requests and destroy the handle while the main loop of the location service runs elsewhere,
+ * as long as a single thread of the application uses the handle.
+ * @param[in] geocoder The geocoder handle
+ * @param[out] fd The file descriptor to poll for #POLLIN
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE Service not available
+ * @see geocoder_dispatch()
+ */
+int geocoder_get_fd(geocoder_h geocoder, int *fd);
+
+/**
+ * @brief Invokes the callbacks of the results queued for the geocoder handle.
+ * @details Callbacks are invoked on the calling thread, in the order the results arrived.
+ * @remarks If results remain after @a max_count callbacks, the file descriptor stays readable.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] max_count The maximum number of results to dispatch, 0 to dispatch all queued results
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @pre geocoder_get_fd() must be called before.
+ * @see geocoder_get_fd()
+ */
+int geocoder_dispatch(geocoder_h geocoder, int max_count);
+
+/**
+ * @brief Selects where the result callbacks of the geocoder handle are invoked.
+ * @details
+ * By default, callbacks are invoked in the context where the map provider answers, so a slow callback delays every other result.
+ * With #GEOCODER_DISPATCH_CONTEXT, they are invoked from the main loop running @a context.
+ * With #GEOCODER_DISPATCH_THREAD_POOL, they are invoked from a pool of threads, possibly several at the same time.
+ * @remarks This applies to geocoder_get_address_from_position(), geocoder_foreach_positions_from_address() and geocoder_get_positions_from_address().
+ * Geocoder handles are not thread safe : callbacks invoked from the thread pool must not call any geocoder function, which then fails with #GEOCODER_ERROR_INVALID_OPERATION.
+ * Hand the results over to a thread of the application to issue further requests from there. \n
+ * Once geocoder_get_fd() is called, callbacks are invoked by geocoder_dispatch() whatever the mode. \n
+ * Results already on their way to the previous context are still delivered there.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] mode The dispatch mode
+ * @param[in] context The GMainContext for #GEOCODER_DISPATCH_CONTEXT, ignored otherwise
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @retval #GEOCODER_ERROR_SERVICE_NOT_AVAILABLE The thread pool cannot be created
+ * @see geocoder_set_callback_budget()
+ */
+int geocoder_set_dispatch_mode(geocoder_h geocoder, geocoder_dispatch_mode_e mode, void *context);
+
+/**
+ * @brief Sets the time a result callback is expected to take.
+ * @details Callbacks running longer are logged and counted, see geocoder_get_callback_overruns(). They are not interrupted.
+ * @param[in] geocoder The geocoder handle
+ * @param[in] budget The time budget in milliseconds, 0 to stop watching callbacks (default)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_get_callback_overruns()
+ */
+int geocoder_set_callback_budget(geocoder_h geocoder, int budget);
+
+/**
+ * @brief Gets the number of result callbacks which ran over the time budget.
+ * @param[in] geocoder The geocoder handle
+ * @param[out] count The number of callbacks over the budget since the geocoder handle was created
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #GEOCODER_ERROR_NONE Successful
+ * @retval #GEOCODER_ERROR_INVALID_PARAMETER	Invalid parameter
+ * @see geocoder_set_callback_budget()
+ */
+int geocoder_get_callback_overruns(geocoder_h geocoder, int *count);
+
 /**
  * @}
  */
@@ -0,0 +1,472 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_LOCATION_GEOCODER_HPP__
+#define __TIZEN_LOCATION_GEOCODER_HPP__
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <geocoder.h>
+
+/**
+ * @addtogroup CAPI_LOCATION_GEOCODER_MODULE
+ * @{
+ */
+
+namespace tizen {
+namespace location {
+
+/**
+ * @brief A position in degrees
+ */
+struct position
+{
+	double latitude;
+	double longitude;
+};
+
+/**
+ * @brief The address information of a position, allocated from the memory resource of the request
+ */
+struct address
+{
+	using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+	explicit address(allocator_type alloc = {})
+		: building_number(alloc), postal_code(alloc), street(alloc), city(alloc), district(alloc), state(alloc), country_code(alloc) {}
+	address(const address &other, allocator_type alloc)
+		: result(other.result), building_number(other.building_number, alloc), postal_code(other.postal_code, alloc), street(other.street, alloc),
+		  city(other.city, alloc), district(other.district, alloc), state(other.state, alloc), country_code(other.country_code, alloc) {}
+	address(address &&other, allocator_type alloc)
+		: result(other.result), building_number(std::move(other.building_number), alloc), postal_code(std::move(other.postal_code), alloc), street(std::move(other.street), alloc),
+		  city(std::move(other.city), alloc), district(std::move(other.district), alloc), state(std::move(other.state), alloc), country_code(std::move(other.country_code), alloc) {}
+	address(const address &) = default;
+	address(address &&) = default;
+	address &operator=(const address &) = default;
+	address &operator=(address &&) = default;
+
+	geocoder_error_e result = GEOCODER_ERROR_NONE;
+	std::pmr::string building_number;
+	std::pmr::string postal_code;
+	std::pmr::string street;
+	std::pmr::string city;
+	std::pmr::string district;
+	std::pmr::string state;
+	std::pmr::string country_code;
+};
+
+/**
+ * @brief The positions of a free-formed address, allocated from the memory resource of the request
+ */
+struct positions
+{
+	using allocator_type = std::pmr::polymorphic_allocator<position>;
+
+	explicit positions(allocator_type alloc = {}) : items(alloc) {}
+	positions(const positions &other, allocator_type alloc) : result(other.result), items(other.items, alloc) {}
+	positions(positions &&other, allocator_type alloc) : result(other.result), items(std::move(other.items), alloc) {}
+	positions(const positions &) = default;
+	positions(positions &&) = default;
+	positions &operator=(const positions &) = default;
+	positions &operator=(positions &&) = default;
+
+	geocoder_error_e result = GEOCODER_ERROR_NONE;
+	std::pmr::vector<position> items;
+};
+
+/**
+ * @brief Thrown when a geocoder handle cannot be created
+ */
+class geocoder_error : public std::runtime_error
+{
+public:
+	explicit geocoder_error(int code) : std::runtime_error("geocoder_create failed"), code_(code) {}
+	int code() const noexcept { return code_; }
+private:
+	int code_;
+};
+
+namespace detail {
+
+inline void assign(std::pmr::string &to, const char *from)
+{
+	if (from)
+		to.assign(from);
+	else
+		to.clear();
+}
+
+inline void fill_address(address &to, geocoder_error_e result, const char *building_number, const char *postal_code, const char *street,
+		const char *city, const char *district, const char *state, const char *country_code)
+{
+	to.result = result;
+	assign(to.building_number, building_number);
+	assign(to.postal_code, postal_code);
+	assign(to.street, street);
+	assign(to.city, city);
+	assign(to.district, district);
+	assign(to.state, state);
+	assign(to.country_code, country_code);
+}
+
+inline void fill_positions(positions &to, geocoder_error_e result, int count, const double *latitudes, const double *longitudes)
+{
+	to.result = result;
+	to.items.clear();
+	to.items.reserve(count);
+	for (int i = 0; i < count; i++)
+		to.items.push_back(position{latitudes[i], longitudes[i]});
+}
+
+/* Fan-out state shared by every request of a *_all awaitable : one completion counter, one resume */
+class fan_out
+{
+protected:
+	explicit fan_out(std::size_t count) : remaining_(count + 1) {}
+
+	/* Returns true for the completion which must resume the awaiting coroutine */
+	bool complete_one() noexcept { return remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+	void complete(std::coroutine_handle<> waiter) noexcept
+	{
+		if (complete_one())
+			waiter.resume();
+	}
+
+	std::atomic<std::size_t> remaining_;
+};
+
+} /* namespace detail */
+
+/**
+ * @brief Awaitable reverse geocoding of one position
+ * @remarks The awaitable lives in the frame of the awaiting coroutine, so a request allocates nothing but its result strings.
+ */
+class reverse_awaitable
+{
+public:
+	reverse_awaitable(geocoder_h handle, double latitude, double longitude, std::pmr::memory_resource *mr)
+		: handle_(handle), latitude_(latitude), longitude_(longitude), result_(address::allocator_type(mr)) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> waiter) noexcept
+	{
+		waiter_ = waiter;
+		int ret = geocoder_get_address_from_position(handle_, latitude_, longitude_, &reverse_awaitable::on_address, this);
+		if (ret != GEOCODER_ERROR_NONE) {
+			result_.result = static_cast<geocoder_error_e>(ret);
+			return false;
+		}
+		return true;
+	}
+
+	address await_resume() { return std::move(result_); }
+
+private:
+	static void on_address(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street,
+			const char *city, const char *district, const char *state, const char *country_code, void *user_data)
+	{
+		reverse_awaitable *self = static_cast<reverse_awaitable *>(user_data);
+		detail::fill_address(self->result_, result, building_number, postal_code, street, city, district, state, country_code);
+		self->waiter_.resume();
+	}
+
+	geocoder_h handle_;
+	double latitude_;
+	double longitude_;
+	address result_;
+	std::coroutine_handle<> waiter_;
+};
+
+/**
+ * @brief Awaitable forward geocoding of one free-formed address
+ */
+class forward_awaitable
+{
+public:
+	forward_awaitable(geocoder_h handle, std::string_view address, std::pmr::memory_resource *mr)
+		: handle_(handle), address_(address, mr), result_(positions::allocator_type(mr)) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> waiter) noexcept
+	{
+		waiter_ = waiter;
+		int ret = geocoder_get_positions_from_address(handle_, address_.c_str(), &forward_awaitable::on_positions, this);
+		if (ret != GEOCODER_ERROR_NONE) {
+			result_.result = static_cast<geocoder_error_e>(ret);
+			return false;
+		}
+		return true;
+	}
+
+	positions await_resume() { return std::move(result_); }
+
+private:
+	static void on_positions(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data)
+	{
+		forward_awaitable *self = static_cast<forward_awaitable *>(user_data);
+		detail::fill_positions(self->result_, result, count, latitudes, longitudes);
+		self->waiter_.resume();
+	}
+
+	geocoder_h handle_;
+	std::pmr::string address_;
+	positions result_;
+	std::coroutine_handle<> waiter_;
+};
+
+/**
+ * @brief Awaitable reverse geocoding of many positions at once
+ * @details Every request is issued when the awaitable is awaited, and the coroutine resumes once when the last one completes.
+ * Results are written to the output vector in the order of the input positions.
+ */
+class reverse_all_awaitable : private detail::fan_out
+{
+public:
+	reverse_all_awaitable(geocoder_h handle, std::span<const position> points, std::pmr::vector<address> &out)
+		: fan_out(points.size()), handle_(handle), points_(points), out_(out), slots_(out.get_allocator()) {}
+
+	bool await_ready() const noexcept { return points_.empty(); }
+
+	bool await_suspend(std::coroutine_handle<> waiter)
+	{
+		waiter_ = waiter;
+		out_.resize(points_.size());
+		slots_.reserve(points_.size());
+		for (std::size_t i = 0; i < points_.size(); i++) {
+			slots_.push_back(slot{this, i});
+			int ret = geocoder_get_address_from_position(handle_, points_[i].latitude, points_[i].longitude, &reverse_all_awaitable::on_address, &slots_[i]);
+			if (ret != GEOCODER_ERROR_NONE) {
+				out_[i].result = static_cast<geocoder_error_e>(ret);
+				complete_one();
+			}
+		}
+		/* Drop the reference held while issuing; suspend only if something is still in flight */
+		return !complete_one();
+	}
+
+	void await_resume() const noexcept {}
+
+private:
+	struct slot
+	{
+		reverse_all_awaitable *self;
+		std::size_t index;
+	};
+
+	static void on_address(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street,
+			const char *city, const char *district, const char *state, const char *country_code, void *user_data)
+	{
+		slot *s = static_cast<slot *>(user_data);
+		reverse_all_awaitable *self = s->self;
+		detail::fill_address(self->out_[s->index], result, building_number, postal_code, street, city, district, state, country_code);
+		self->complete(self->waiter_);
+	}
+
+	geocoder_h handle_;
+	std::span<const position> points_;
+	std::pmr::vector<address> &out_;
+	std::pmr::vector<slot> slots_;
+	std::coroutine_handle<> waiter_;
+};
+
+/**
+ * @brief Awaitable forward geocoding of many free-formed addresses at once
+ * @details Results are written to the output vector in the order of the input addresses.
+ */
+class forward_all_awaitable : private detail::fan_out
+{
+public:
+	forward_all_awaitable(geocoder_h handle, std::span<const std::string_view> addresses, std::pmr::vector<positions> &out)
+		: fan_out(addresses.size()), handle_(handle), addresses_(addresses), out_(out), slots_(out.get_allocator()) {}
+
+	bool await_ready() const noexcept { return addresses_.empty(); }
+
+	bool await_suspend(std::coroutine_handle<> waiter)
+	{
+		waiter_ = waiter;
+		out_.resize(addresses_.size());
+		slots_.reserve(addresses_.size());
+		for (std::size_t i = 0; i < addresses_.size(); i++) {
+			slots_.emplace_back(this, i, addresses_[i]);
+			int ret = geocoder_get_positions_from_address(handle_, slots_[i].address.c_str(), &forward_all_awaitable::on_positions, &slots_[i]);
+			if (ret != GEOCODER_ERROR_NONE) {
+				out_[i].result = static_cast<geocoder_error_e>(ret);
+				complete_one();
+			}
+		}
+		return !complete_one();
+	}
+
+	void await_resume() const noexcept {}
+
+private:
+	struct slot
+	{
+		using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+		slot(forward_all_awaitable *s, std::size_t i, std::string_view a, allocator_type alloc = {}) : self(s), index(i), address(a, alloc) {}
+		slot(slot &&other, allocator_type alloc) : self(other.self), index(other.index), address(std::move(other.address), alloc) {}
+
+		forward_all_awaitable *self;
+		std::size_t index;
+		std::pmr::string address;
+	};
+
+	static void on_positions(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data)
+	{
+		slot *s = static_cast<slot *>(user_data);
+		forward_all_awaitable *self = s->self;
+		detail::fill_positions(self->out_[s->index], result, count, latitudes, longitudes);
+		self->complete(self->waiter_);
+	}
+
+	geocoder_h handle_;
+	std::span<const std::string_view> addresses_;
+	std::pmr::vector<positions> &out_;
+	std::pmr::vector<slot> slots_;
+	std::coroutine_handle<> waiter_;
+};
+
+/**
+ * @brief Fire-and-forget coroutine awaiting geocoder requests
+ * @details
+ * The coroutine runs until its first suspension when called, then is resumed by the geocoder callbacks; its frame is freed when it returns.
+ * A coroutine whose first parameters are std::allocator_arg and a std::pmr::polymorphic_allocator<> gets its frame from that allocator:
+ * @code
+ * task lookup(std::allocator_arg_t, std::pmr::polymorphic_allocator<>, geocoder &coder);
+ * lookup(std::allocator_arg, &pool, coder);
+ * @endcode
+ * Other coroutines get it from the default memory resource. The memory resource must outlive the coroutine.
+ */
+class task
+{
+public:
+	class promise_type
+	{
+	public:
+		task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+
+		template <typename... Args>
+		static void *operator new(std::size_t size, std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, Args &...)
+		{
+			return allocate(size, alloc.resource());
+		}
+
+		static void *operator new(std::size_t size) { return allocate(size, std::pmr::get_default_resource()); }
+
+		static void operator delete(void *frame, std::size_t size) noexcept
+		{
+			std::pmr::memory_resource *mr;
+			std::memcpy(&mr, static_cast<char *>(frame) + resource_offset(size), sizeof(mr));
+			mr->deallocate(frame, resource_offset(size) + sizeof(mr), alignof(std::max_align_t));
+		}
+
+	private:
+		/* The memory resource is kept after the frame, so that operator delete finds it from the frame size */
+		static constexpr std::size_t resource_offset(std::size_t size) noexcept
+		{
+			return (size + alignof(std::pmr::memory_resource *) - 1) & ~(alignof(std::pmr::memory_resource *) - 1);
+		}
+
+		static void *allocate(std::size_t size, std::pmr::memory_resource *mr)
+		{
+			void *frame = mr->allocate(resource_offset(size) + sizeof(mr), alignof(std::max_align_t));
+			std::memcpy(static_cast<char *>(frame) + resource_offset(size), &mr, sizeof(mr));
+			return frame;
+		}
+	};
+};
+
+/**
+ * @brief Owns a geocoder handle and creates awaitable requests on it
+ * @details
+ * @code
+ * address a = co_await coder.reverse(37.258, 127.056);
+ * co_await coder.reverse_all(points, results);
+ * @endcode
+ * Coroutines resume on the thread which invokes the geocoder callbacks, i.e. the main loop of the location service or the caller of geocoder_dispatch().
+ * The awaitables must be awaited by the coroutine which created them, and the geocoder must outlive them.
+ */
+class geocoder
+{
+public:
+	using task = location::task;
+
+	explicit geocoder(std::pmr::memory_resource *mr = std::pmr::get_default_resource()) : mr_(mr)
+	{
+		int ret = geocoder_create(&handle_);
+		if (ret != GEOCODER_ERROR_NONE)
+			throw geocoder_error(ret);
+	}
+
+	~geocoder()
+	{
+		if (handle_)
+			geocoder_destroy(handle_);
+	}
+
+	geocoder(geocoder &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)), mr_(other.mr_) {}
+	geocoder &operator=(geocoder &&other) noexcept
+	{
+		std::swap(handle_, other.handle_);
+		std::swap(mr_, other.mr_);
+		return *this;
+	}
+	geocoder(const geocoder &) = delete;
+	geocoder &operator=(const geocoder &) = delete;
+
+	geocoder_h native_handle() const noexcept { return handle_; }
+
+	reverse_awaitable reverse(double latitude, double longitude) const { return reverse_awaitable(handle_, latitude, longitude, mr_); }
+	reverse_awaitable reverse(position p) const { return reverse(p.latitude, p.longitude); }
+	forward_awaitable forward(std::string_view address) const { return forward_awaitable(handle_, address, mr_); }
+
+	/* The output vectors carry the allocator of the results */
+	reverse_all_awaitable reverse_all(std::span<const position> points, std::pmr::vector<address> &out) const { return reverse_all_awaitable(handle_, points, out); }
+	forward_all_awaitable forward_all(std::span<const std::string_view> addresses, std::pmr::vector<positions> &out) const { return forward_all_awaitable(handle_, addresses, out); }
+
+private:
+	geocoder_h handle_ = nullptr;
+	std::pmr::memory_resource *mr_;
+};
+
+} /* namespace location */
+} /* namespace tizen */
+
+/**
+ * @}
+ */
+
+#endif /* __TIZEN_LOCATION_GEOCODER_HPP__ */
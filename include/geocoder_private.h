@@ -29,13 +29,200 @@ extern "C" {
 typedef enum {
 	_GEOCODER_CB_ADDRESS_FROM_POSITION,
 	_GEOCODER_CB_POSITION_FROM_ADDRESS,
+	_GEOCODER_CB_POSITIONS_FROM_ADDRESS,
 	_GEOCODER_CB_TYPE_NUM
 }_geocoder_cb_e;
 
+#define _GEOCODER_RETRY_MAX_DEFAULT		2
+#define _GEOCODER_RETRY_BASE_DELAY_DEFAULT	200	/* msec */
+#define _GEOCODER_RETRY_MAX_DELAY_DEFAULT	5000	/* msec */
+#define _GEOCODER_RETRY_BUDGET_RATIO		0.1	/* retry tokens earned per request */
+#define _GEOCODER_RETRY_BUDGET_MAX		10.0
+
+#define _GEOCODER_BREAKER_FAILURE_THRESHOLD	5
+#define _GEOCODER_BREAKER_OPEN_DURATION		30000	/* msec */
+#define _GEOCODER_BREAKER_HALF_OPEN_PROBES	1
+
+#define _GEOCODER_TILE_BUDGET_DEFAULT		(16 * 1024 * 1024)	/* bytes mapped */
+#define _GEOCODER_TILE_REVERSE_RADIUS		100.0	/* meters, an offline address this close stands for the position */
+
+#define _GEOCODER_EARTH_RADIUS			6371008.8	/* meters */
+
+typedef enum {
+	_GEOCODER_BREAKER_CLOSED,
+	_GEOCODER_BREAKER_OPEN,
+	_GEOCODER_BREAKER_HALF_OPEN,
+}_geocoder_breaker_state_e;
+
+/* Shared by every handle talking to the same map provider */
+typedef struct _geocoder_breaker_s{
+	gchar *provider;
+	_geocoder_breaker_state_e state;
+	int failures;
+	int probes;
+	gint64 opened_at;
+} geocoder_breaker_s;
+
+/* Result of a request, kept until the application dispatches it */
+typedef struct _geocoder_completion_s{
+	struct _geocoder_completion_s *next;
+	_geocoder_cb_e type;
+	int error;
+	union {
+		geocoder_get_address_cb address;
+		geocoder_get_position_cb position;
+		geocoder_get_positions_cb positions;
+	} callback;
+	void *user_data;
+	bool interned;			/* the five strings below are shared interned ones, not owned copies */
+	gchar *building_number;
+	gchar *postal_code;
+	gchar *street;
+	gchar *city;
+	gchar *district;
+	const gchar *state;		/* always interned */
+	const gchar *country_code;	/* always interned */
+	int count;
+	double *latitudes;
+	double *longitudes;
+} geocoder_completion_s;
+
+typedef enum {
+	_GEOCODER_BOUNDARY_COUNTRY,
+	_GEOCODER_BOUNDARY_STATE,
+	_GEOCODER_BOUNDARY_CITY,
+	_GEOCODER_BOUNDARY_DISTRICT,
+	_GEOCODER_BOUNDARY_LEVEL_NUM
+}_geocoder_boundary_level_e;
+
+typedef struct _geocoder_gazetteer_s geocoder_gazetteer_s;
+typedef struct _geocoder_boundary_s geocoder_boundary_s;
+typedef struct _geocoder_cache_s geocoder_cache_s;
+typedef struct _geocoder_trace_s geocoder_trace_s;
+typedef struct _geocoder_dispatch_s geocoder_dispatch_s;
+typedef struct _geocoder_offline_s geocoder_offline_s;
+typedef struct _geocoder_tiles_s geocoder_tiles_s;
+
+typedef struct _geocoder_offline_address_s{
+	double xyz[3];		/* unit vector on the sphere */
+	double latitude;
+	double longitude;
+	gchar *building_number;
+	const gchar *postal_code;	/* interned */
+	gchar *street;
+	const gchar *city;		/* interned */
+	const gchar *district;		/* interned */
+	const gchar *state;		/* interned */
+	const gchar *country_code;	/* interned */
+} geocoder_offline_address_s;
+
+typedef struct {
+	gconstpointer record;
+	double chord2;
+} geocoder_offline_neighbour_s;
+
+typedef struct {
+	double target[3];
+	double bound2;		/* squared chord of the search radius */
+	int max_count;		/* 0 : every address within the radius */
+	GArray *found;		/* geocoder_offline_neighbour_s, max-heap on chord2 when max_count is set */
+} geocoder_offline_search_s;
+
 typedef struct _geocoder_s{
 	LocationMapObject* object;
+	geocoder_breaker_s* breaker;
+	GList* requests;		/* with the retry fields, guarded by _geocoder_request_lock() */
+	int retry_max;
+	int retry_base_delay;
+	int retry_max_delay;
+	double retry_tokens;
+	int event_fd;
+	geocoder_completion_s *completion_head;		/* pushed by producers, lock-free */
+	geocoder_completion_s *completion_pending;	/* owned by the dispatching thread */
+	geocoder_gazetteer_s *gazetteer;
+	geocoder_offline_s *offline;
+	geocoder_tiles_s *tiles;		/* offline data mapped on demand, preferred to offline */
+	int tile_budget;
+	geocoder_boundary_s *boundary;
+	geocoder_cache_s *cache;		/* shared between processes */
+	geocoder_trace_s *trace;
+	geocoder_dispatch_s *dispatch;		/* where callbacks run, unless the completion fd is used */
 } geocoder_s;
 
+void _geocoder_request_lock(void);
+void _geocoder_request_unlock(void);
+
+geocoder_completion_s* _geocoder_completion_new_address(int error, const LocationAddress *addr, geocoder_get_address_cb callback, void *user_data);
+geocoder_completion_s* _geocoder_completion_new_interned_address(const LocationAddress *addr, geocoder_get_address_cb callback, void *user_data);
+geocoder_completion_s* _geocoder_completion_new_positions(int error, GList *position_list, _geocoder_cb_e type, void *callback, void *user_data);
+void _geocoder_completion_invoke(geocoder_completion_s *completion);
+void _geocoder_completion_free(geocoder_completion_s *completion);
+int _geocoder_completion_open(geocoder_s *handle);
+void _geocoder_completion_close(geocoder_s *handle);
+void _geocoder_completion_push(geocoder_s *handle, geocoder_completion_s *completion);
+int _geocoder_completion_dispatch(geocoder_s *handle, int max_count);
+
+gchar* _geocoder_gazetteer_key(const char *text);
+int _geocoder_gazetteer_load(const char *path, geocoder_gazetteer_s **gazetteer);
+void _geocoder_gazetteer_free(geocoder_gazetteer_s *gazetteer);
+int _geocoder_gazetteer_lookup(geocoder_gazetteer_s *gazetteer, const char *prefix, int max_count, geocoder_suggestion_cb callback, void *user_data);
+
+int _geocoder_offline_load(const char *path, geocoder_offline_s **offline);
+void _geocoder_offline_free(geocoder_offline_s *offline);
+geocoder_offline_address_s* _geocoder_offline_addresses(geocoder_offline_s *offline, int *count);
+int _geocoder_offline_nearest(geocoder_offline_s *offline, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data);
+void _geocoder_offline_unit_vector(double latitude, double longitude, double *xyz);
+double _geocoder_offline_meters(double chord2);
+void _geocoder_offline_build(geocoder_offline_address_s *addresses, int count);
+void _geocoder_offline_search_begin(geocoder_offline_search_s *search, double latitude, double longitude, int max_count, double radius);
+void _geocoder_offline_search_run(geocoder_offline_search_s *search, gconstpointer records, int count, gsize stride);
+int _geocoder_offline_search_end(geocoder_offline_search_s *search);
+
+int _geocoder_tiles_open(const char *directory, gsize budget, geocoder_tiles_s **tiles);
+void _geocoder_tiles_close(geocoder_tiles_s *tiles);
+void _geocoder_tiles_set_budget(geocoder_tiles_s *tiles, gsize budget);
+int _geocoder_tiles_nearest(geocoder_tiles_s *tiles, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data);
+int _geocoder_tiles_update(geocoder_tiles_s *tiles, const char *tile, const char *path);
+int _geocoder_tiles_export(geocoder_offline_s *offline, const char *directory);
+
+int _geocoder_boundary_load(const char *path, geocoder_boundary_s **boundary);
+void _geocoder_boundary_free(geocoder_boundary_s *boundary);
+int _geocoder_boundary_lookup(geocoder_boundary_s *boundary, double latitude, double longitude, const char **names);
+
+const gchar* _geocoder_intern(const gchar *str);
+
+LocationAddress* _geocoder_parser_parse(const char *address);
+gchar* _geocoder_parser_key(const LocationAddress *parsed);
+
+int _geocoder_cache_open(const char *name, gsize max_size, geocoder_cache_s **cache);
+void _geocoder_cache_close(geocoder_cache_s *cache);
+geocoder_completion_s* _geocoder_cache_lookup_address(geocoder_cache_s *cache, double latitude, double longitude);
+void _geocoder_cache_store_address(geocoder_cache_s *cache, double latitude, double longitude, const LocationAddress *addr);
+geocoder_completion_s* _geocoder_cache_lookup_positions(geocoder_cache_s *cache, const char *address, _geocoder_cb_e type);
+void _geocoder_cache_store_positions(geocoder_cache_s *cache, const char *address, GList *position_list);
+
+geocoder_dispatch_s* _geocoder_dispatch_new(geocoder_dispatch_mode_e mode, GMainContext *context);
+geocoder_dispatch_s* _geocoder_dispatch_ref(geocoder_dispatch_s *dispatch);
+void _geocoder_dispatch_unref(geocoder_dispatch_s *dispatch);
+void _geocoder_dispatch_release(geocoder_dispatch_s *dispatch, geocoder_dispatch_s *successor);
+bool _geocoder_dispatch_is_inline(geocoder_dispatch_s *dispatch);
+bool _geocoder_dispatch_in_pool(void);
+void _geocoder_dispatch_post(geocoder_dispatch_s *dispatch, geocoder_completion_s *completion);
+void _geocoder_dispatch_run(geocoder_dispatch_s *dispatch, geocoder_completion_s *completion);
+void _geocoder_dispatch_watch(geocoder_dispatch_s *dispatch, _geocoder_cb_e type, gint64 started);
+void _geocoder_dispatch_set_budget(geocoder_dispatch_s *dispatch, int budget);
+int _geocoder_dispatch_get_budget(geocoder_dispatch_s *dispatch);
+int _geocoder_dispatch_get_overruns(geocoder_dispatch_s *dispatch);
+void _geocoder_dispatch_add_overruns(geocoder_dispatch_s *dispatch, int overruns);
+
+int _geocoder_trace_open(geocoder_trace_mode_e mode, const char *path, geocoder_trace_s **trace);
+void _geocoder_trace_close(geocoder_trace_s *trace);
+bool _geocoder_trace_replaying(geocoder_trace_s *trace);
+int _geocoder_trace_replay_address(geocoder_trace_s *trace, double latitude, double longitude, LocationAddressCB callback, gpointer userdata);
+int _geocoder_trace_replay_position(geocoder_trace_s *trace, const char *address, LocationPositionCB callback, gpointer userdata);
+void _geocoder_trace_record_address(geocoder_trace_s *trace, gint64 issued, double latitude, double longitude, LocationError error, const LocationAddress *addr, const LocationAccuracy *acc);
+void _geocoder_trace_record_position(geocoder_trace_s *trace, gint64 issued, const char *address, LocationError error, GList *position_list, GList *accuracy_list);
+
 #ifdef __cplusplus
 }
 #endif
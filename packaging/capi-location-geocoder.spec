@@ -6,6 +6,7 @@ Group:      API/C API
 License:    Apache-2.0
 Source0:    %{name}-%{version}.tar.gz
 BuildRequires:  cmake
+BuildRequires:  gcc-c++
 BuildRequires:  pkgconfig(dlog)
 BuildRequires:  pkgconfig(location)
 BuildRequires:  pkgconfig(capi-base-common)
@@ -45,7 +46,9 @@ make %{?jobs:-j%jobs}
 
 %files
 %{_libdir}/libcapi-location-geocoder.so*
+%{_bindir}/geocoder-bulk
 
 %files devel
 %{_includedir}/location/geocoder.h
+%{_includedir}/location/geocoder.hpp
 %{_libdir}/pkgconfig/*.pc
@@ -35,20 +35,64 @@
 #define GEOCODER_NULL_ARG_CHECK(arg)	\
 	GEOCODER_CHECK_CONDITION(arg != NULL,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER")
 
+/* Handles are not thread safe, pool callbacks would race with the backend's context and with each other */
+#define GEOCODER_POOL_CHECK()	\
+	GEOCODER_CHECK_CONDITION(!_geocoder_dispatch_in_pool(),GEOCODER_ERROR_INVALID_OPERATION,"GEOCODER_ERROR_INVALID_OPERATION")
+
 /*
 * Internal Implementation
 */
 
+/* Common header of the callback data, tracked by the handle until the request finishes */
+typedef struct {
+	geocoder_s *handle;
+	_geocoder_cb_e type;
+	int attempt;
+	guint retry_id;
+	gint64 issued;			/* monotonic time the backend was last asked */
+	geocoder_completion_s *cached;	/* answered without the provider, delivered from an idle source */
+	geocoder_breaker_s *breaker;	/* holding one of its half-open probes, NULL : none */
+}__request_data;
+
 typedef struct {
+	__request_data req;
 	void *data;
 	geocoder_get_address_cb callback;
+	double latitude;
+	double longitude;
 }__addr_callback_data;
 
 typedef struct {
+	__request_data req;
 	void *data;
 	geocoder_get_position_cb callback;
+	geocoder_get_positions_cb positions_callback;
+	char *address;
+	LocationAddress *parsed;	/* sent as a structured query, NULL : freeform */
+	gchar *cache_key;		/* from the parsed components, NULL : the address itself */
 }__pos_callback_data;
 
+G_LOCK_DEFINE_STATIC(breaker);
+static GList *__breakers = NULL;
+
+/*
+* The backend answers from the default main context, while the application may issue requests, destroy the handle
+* or dispatch the completion fd from another thread. Both sides hold this lock while they touch the requests of a
+* handle, its retry budget or the pointers the backend's callbacks follow. It is recursive since callbacks invoked
+* under it may issue requests, and static since it outlives the handles.
+*/
+static GRecMutex __request_lock;
+
+void _geocoder_request_lock(void)
+{
+	g_rec_mutex_lock(&__request_lock);
+}
+
+void _geocoder_request_unlock(void)
+{
+	g_rec_mutex_unlock(&__request_lock);
+}
+
 static int __convert_error_code(int code, char* func_name)
 {
 	int ret;
@@ -84,39 +128,265 @@ static int __convert_error_code(int code, char* func_name)
 	return ret;	
 }
 
-static void __cb_address_from_position (LocationError error, LocationAddress *addr, LocationAccuracy *acc, gpointer userdata)
+static bool __is_transient_error(int error)
 {
-	__addr_callback_data * callback = (__addr_callback_data*)userdata;
-	if( callback == NULL || callback->callback == NULL)
+	/* The location framework reports no timeout of its own, a stalled provider surfaces as a network failure */
+	return (error == GEOCODER_ERROR_NETWORK_FAILED);
+}
+
+/*
+* Circuit breaker
+*/
+static geocoder_breaker_s* __breaker_get(const char *provider)
+{
+	GList *iter;
+	geocoder_breaker_s *breaker = NULL;
+
+	if(provider == NULL)
+		provider = "default";
+
+	G_LOCK(breaker);
+	for(iter = __breakers; iter != NULL; iter = g_list_next(iter))
 	{
-		LOGI("[%s] callback is NULL )",__FUNCTION__);
-		return ;
+		if(g_strcmp0(((geocoder_breaker_s*)iter->data)->provider, provider) == 0)
+		{
+			breaker = iter->data;
+			break;
+		}
 	}
+	if(breaker == NULL)
+	{
+		breaker = g_new0(geocoder_breaker_s, 1);
+		breaker->provider = g_strdup(provider);
+		breaker->state = _GEOCODER_BREAKER_CLOSED;
+		__breakers = g_list_prepend(__breakers, breaker);
+	}
+	G_UNLOCK(breaker);
+	return breaker;
+}
 
-	if(error != LOCATION_ERROR_NONE || addr == NULL)
+static bool __breaker_allow(geocoder_breaker_s *breaker, __request_data *req)
+{
+	bool allow = true;
+
+	G_LOCK(breaker);
+	if(breaker->state == _GEOCODER_BREAKER_OPEN && g_get_monotonic_time() - breaker->opened_at >= (gint64)_GEOCODER_BREAKER_OPEN_DURATION * 1000)
+	{
+		LOGI("[%s] provider %s : half-open, probing", __FUNCTION__, breaker->provider);
+		breaker->state = _GEOCODER_BREAKER_HALF_OPEN;
+		breaker->probes = 0;
+	}
+
+	if(breaker->state == _GEOCODER_BREAKER_OPEN)
+	{
+		allow = false;
+	}
+	else if(breaker->state == _GEOCODER_BREAKER_HALF_OPEN)
+	{
+		if(breaker->probes < _GEOCODER_BREAKER_HALF_OPEN_PROBES)
+		{
+			breaker->probes++;
+			req->breaker = breaker;
+		}
+		else
+			allow = false;
+	}
+	G_UNLOCK(breaker);
+	return allow;
+}
+
+/* A probe abandoned with its request gives its slot back without judging the provider */
+static void __breaker_release(__request_data *req)
+{
+	if(req->breaker == NULL)
+		return;
+
+	G_LOCK(breaker);
+	if(req->breaker->probes > 0)
+		req->breaker->probes--;
+	G_UNLOCK(breaker);
+	req->breaker = NULL;
+}
+
+static void __breaker_record(geocoder_breaker_s *breaker, __request_data *req, int error)
+{
+	bool failure = (__is_transient_error(error) || error == GEOCODER_ERROR_SERVICE_NOT_AVAILABLE);
+
+	__breaker_release(req);
+	G_LOCK(breaker);
+	if(breaker->state == _GEOCODER_BREAKER_HALF_OPEN)
+	{
+		if(failure)
+		{
+			LOGI("[%s] provider %s : probe failed, open again", __FUNCTION__, breaker->provider);
+			breaker->state = _GEOCODER_BREAKER_OPEN;
+			breaker->opened_at = g_get_monotonic_time();
+		}
+		else
+		{
+			LOGI("[%s] provider %s : recovered", __FUNCTION__, breaker->provider);
+			breaker->state = _GEOCODER_BREAKER_CLOSED;
+			breaker->failures = 0;
+		}
+	}
+	else if(breaker->state == _GEOCODER_BREAKER_CLOSED)
+	{
+		if(!failure)
+		{
+			breaker->failures = 0;
+		}
+		else if(++breaker->failures >= _GEOCODER_BREAKER_FAILURE_THRESHOLD)
+		{
+			LOGE("[%s] provider %s : %d consecutive failures, open", __FUNCTION__, breaker->provider, breaker->failures);
+			breaker->state = _GEOCODER_BREAKER_OPEN;
+			breaker->opened_at = g_get_monotonic_time();
+		}
+	}
+	G_UNLOCK(breaker);
+}
+
+/*
+* Retry
+*/
+static bool __retry_acquire(geocoder_s *handle, int attempt)
+{
+	if(handle == NULL || attempt >= handle->retry_max || handle->retry_tokens < 1.0)
+		return false;
+	handle->retry_tokens -= 1.0;
+	return true;
+}
+
+static guint __retry_delay(geocoder_s *handle, int attempt)
+{
+	guint delay = handle->retry_base_delay;
+	while(attempt-- > 0 && delay < (guint)handle->retry_max_delay)
+		delay <<= 1;
+	delay = MIN(delay, (guint)handle->retry_max_delay);
+	/* equal jitter : half fixed, half random */
+	return delay / 2 + g_random_int_range(0, delay / 2 + 1);
+}
+
+static void __request_finish(geocoder_s *handle, gpointer calldata)
+{
+	if(handle != NULL)
+		handle->requests = g_list_remove(handle->requests, calldata);
+}
+
+static void __cb_address_from_position (LocationError error, LocationAddress *addr, LocationAccuracy *acc, gpointer userdata);
+static void __cb_position_from_address (LocationError error, GList *position_list, GList *accuracy_list, gpointer userdata);
+
+static int __request_address(__addr_callback_data *calldata)
+{
+	int ret;
+	LocationPosition *pos = NULL;
+
+	calldata->req.issued = g_get_monotonic_time();
+	if(_geocoder_trace_replaying(calldata->req.handle->trace))
+		return _geocoder_trace_replay_address(calldata->req.handle->trace, calldata->latitude, calldata->longitude, __cb_address_from_position, calldata);
+
+	pos = location_position_new (0, calldata->latitude, calldata->longitude, 0, LOCATION_STATUS_2D_FIX);
+	ret = location_map_get_address_from_position_async(calldata->req.handle->object, pos, __cb_address_from_position, calldata);
+	location_position_free(pos);
+	return ret;
+}
+
+static int __request_position(__pos_callback_data *calldata)
+{
+	calldata->req.issued = g_get_monotonic_time();
+	if(_geocoder_trace_replaying(calldata->req.handle->trace))
+		return _geocoder_trace_replay_position(calldata->req.handle->trace, calldata->address, __cb_position_from_address, calldata);
+
+	if(calldata->parsed != NULL)
+		return location_map_get_position_from_address_async(calldata->req.handle->object, calldata->parsed, __cb_position_from_address, calldata);
+	return location_map_get_position_from_freeformed_address_async(calldata->req.handle->object, calldata->address, __cb_position_from_address, calldata);
+}
+
+static void __pos_callback_free(__pos_callback_data *calldata)
+{
+	if(calldata->parsed != NULL)
+		location_address_free(calldata->parsed);
+	g_free(calldata->cache_key);
+	g_free(calldata->address);
+	free(calldata);
+}
+
+/* Results leave the backend's context, through the completion fd or the dispatcher the application chose */
+static bool __deliver_elsewhere(geocoder_s *handle)
+{
+	return handle != NULL && (handle->event_fd >= 0 || !_geocoder_dispatch_is_inline(handle->dispatch));
+}
+
+static void __deliver_completion(geocoder_s *handle, geocoder_completion_s *completion)
+{
+	if(handle->event_fd >= 0)
+		_geocoder_completion_push(handle, completion);
+	else
+		_geocoder_dispatch_post(handle->dispatch, completion);
+}
+
+static void __deliver_address(__addr_callback_data *callback, int error, LocationAddress *addr)
+{
+	geocoder_s *handle = callback->req.handle;
+	geocoder_dispatch_s *dispatch = NULL;
+	gint64 started;
+
+	__request_finish(handle, callback);
+	if(__deliver_elsewhere(handle))
+	{
+		__deliver_completion(handle, _geocoder_completion_new_address(error, addr, callback->callback, callback->data));
+		free(callback);
+		return;
+	}
+
+	if(handle != NULL)
+		dispatch = _geocoder_dispatch_ref(handle->dispatch);
+	started = g_get_monotonic_time();
+	if(addr == NULL)
 	{
-		callback->callback(__convert_error_code(error,(char*)__FUNCTION__), NULL,  NULL,  NULL,  NULL,  NULL,  NULL,  NULL, callback->data);
+		callback->callback(error, NULL,  NULL,  NULL,  NULL,  NULL,  NULL,  NULL, callback->data);
 	}
 	else
 	{
-		LOGI("[%s] Address - building number: %s, postal code: %s, street: %s, city: %s, district:  %s, state: %s, country code: %s", __FUNCTION__ , addr->building_number, addr->postal_code, addr->street, addr->city, addr->district, addr->state, addr->country_code);
-		callback->callback(GEOCODER_ERROR_NONE, addr->building_number, addr->postal_code, addr->street, addr->city, addr->district, addr->state, addr->country_code, callback->data);
+		callback->callback(error, addr->building_number, addr->postal_code, addr->street, addr->city, addr->district, addr->state, addr->country_code, callback->data);
+	}
+	if(dispatch != NULL)
+	{
+		_geocoder_dispatch_watch(dispatch, _GEOCODER_CB_ADDRESS_FROM_POSITION, started);
+		_geocoder_dispatch_unref(dispatch);
 	}
 	free(callback);
 }
 
-static void __cb_position_from_address (LocationError error, GList *position_list, GList *accuracy_list, gpointer userdata)
+static void __deliver_positions(__pos_callback_data *callback, int error, GList *position_list)
 {
-	__pos_callback_data * callback = (__pos_callback_data*)userdata;
-	if( callback == NULL || callback->callback == NULL)
+	geocoder_s *handle = callback->req.handle;
+	geocoder_dispatch_s *dispatch = NULL;
+	gint64 started;
+
+	__request_finish(handle, callback);
+	if(__deliver_elsewhere(handle))
 	{
-		LOGI("[%s] callback is NULL )",__FUNCTION__);
-		return ;
+		if(callback->req.type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+			__deliver_completion(handle, _geocoder_completion_new_positions(error, position_list, callback->req.type, callback->positions_callback, callback->data));
+		else
+			__deliver_completion(handle, _geocoder_completion_new_positions(error, position_list, callback->req.type, callback->callback, callback->data));
+		__pos_callback_free(callback);
+		return;
 	}
 
-	if(error != LOCATION_ERROR_NONE || position_list == NULL || position_list->data ==NULL || accuracy_list==NULL )
+	if(handle != NULL)
+		dispatch = _geocoder_dispatch_ref(handle->dispatch);
+	started = g_get_monotonic_time();
+	if(callback->req.type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+	{
+		/* The whole list is handed over at once, so flatten it first */
+		geocoder_completion_s *completion = _geocoder_completion_new_positions(error, position_list, callback->req.type, callback->positions_callback, callback->data);
+		_geocoder_completion_invoke(completion);
+		_geocoder_completion_free(completion);
+	}
+	else if(position_list == NULL)
 	{
-		callback->callback(__convert_error_code(error,(char*)__FUNCTION__), 0, 0, callback->data);
+		callback->callback(error, 0, 0, callback->data);
 	}
 	else
 	{
@@ -131,14 +401,474 @@ static void __cb_position_from_address (LocationError error, GList *position_lis
 			position_list = g_list_next(position_list);
 		}
 	}
+	if(dispatch != NULL)
+	{
+		_geocoder_dispatch_watch(dispatch, callback->req.type, started);
+		_geocoder_dispatch_unref(dispatch);
+	}
+	__pos_callback_free(callback);
+}
+
+static gboolean __deliver_cached(gpointer userdata)
+{
+	__request_data *req = (__request_data*)userdata;
+	geocoder_completion_s *completion;
+
+	_geocoder_request_lock();
+	if(g_source_is_destroyed(g_main_current_source()))
+	{
+		/* geocoder_destroy() freed the request while this waited for the lock */
+		_geocoder_request_unlock();
+		return FALSE;
+	}
+	completion = req->cached;
+	req->retry_id = 0;
+	__request_finish(req->handle, req);
+	__deliver_completion(req->handle, completion);
+	if(req->type != _GEOCODER_CB_ADDRESS_FROM_POSITION)
+		__pos_callback_free((__pos_callback_data*)req);
+	else
+		free(req);
+	_geocoder_request_unlock();
+	return FALSE;
+}
+
+/* Answers from the shared cache or the boundaries still reach the application asynchronously, as the provider's do */
+static void __defer_cached(geocoder_s *handle, __request_data *req, geocoder_completion_s *completion)
+{
+	req->cached = completion;
+	handle->requests = g_list_prepend(handle->requests, req);
+	req->retry_id = g_idle_add(__deliver_cached, req);
+}
+
+static void __reissue_address(__addr_callback_data *callback)
+{
+	int ret;
+
+	callback->req.retry_id = 0;
+	if(!__breaker_allow(callback->req.handle->breaker, &callback->req))
+	{
+		__deliver_address(callback, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, NULL);
+		return;
+	}
+
+	LOGI("[%s] retry %d", __FUNCTION__, callback->req.attempt);
+	ret = __request_address(callback);
+	if(ret != LOCATION_ERROR_NONE)
+	{
+		ret = __convert_error_code(ret,(char*)__FUNCTION__);
+		__breaker_record(callback->req.handle->breaker, &callback->req, ret);
+		__deliver_address(callback, ret, NULL);
+	}
+}
+
+static gboolean __retry_address(gpointer userdata)
+{
+	_geocoder_request_lock();
+	/* Unless geocoder_destroy() freed the request while this waited for the lock */
+	if(!g_source_is_destroyed(g_main_current_source()))
+		__reissue_address((__addr_callback_data*)userdata);
+	_geocoder_request_unlock();
+	return FALSE;
+}
+
+static void __reissue_position(__pos_callback_data *callback)
+{
+	int ret;
+
+	callback->req.retry_id = 0;
+	/* The freeform fallback still holds the probe of the parsed request */
+	if(callback->req.breaker == NULL && !__breaker_allow(callback->req.handle->breaker, &callback->req))
+	{
+		__deliver_positions(callback, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, NULL);
+		return;
+	}
+
+	LOGI("[%s] retry %d", __FUNCTION__, callback->req.attempt);
+	ret = __request_position(callback);
+	if(ret != LOCATION_ERROR_NONE)
+	{
+		ret = __convert_error_code(ret,(char*)__FUNCTION__);
+		__breaker_record(callback->req.handle->breaker, &callback->req, ret);
+		__deliver_positions(callback, ret, NULL);
+	}
+}
+
+static gboolean __retry_position(gpointer userdata)
+{
+	_geocoder_request_lock();
+	/* Unless geocoder_destroy() freed the request while this waited for the lock */
+	if(!g_source_is_destroyed(g_main_current_source()))
+		__reissue_position((__pos_callback_data*)userdata);
+	_geocoder_request_unlock();
+	return FALSE;
+}
+
+static void __on_address(__addr_callback_data *callback, LocationError error, LocationAddress *addr, LocationAccuracy *acc)
+{
+	if(callback->req.handle == NULL)
+	{
+		/* The handle was destroyed while the request was in flight, nobody is waiting for it any more */
+		free(callback);
+		return;
+	}
+
+	if(callback->req.handle->trace != NULL)
+		_geocoder_trace_record_address(callback->req.handle->trace, callback->req.issued, callback->latitude, callback->longitude, error, addr, acc);
+
+	if(error != LOCATION_ERROR_NONE || addr == NULL)
+	{
+		int ret = __convert_error_code(error,(char*)__FUNCTION__);
+		__breaker_record(callback->req.handle->breaker, &callback->req, ret);
+		if(__is_transient_error(ret) && __retry_acquire(callback->req.handle, callback->req.attempt))
+		{
+			callback->req.retry_id = g_timeout_add(__retry_delay(callback->req.handle, callback->req.attempt), __retry_address, callback);
+			callback->req.attempt++;
+			return;
+		}
+		__deliver_address(callback, ret, NULL);
+		return;
+	}
+
+	__breaker_record(callback->req.handle->breaker, &callback->req, GEOCODER_ERROR_NONE);
+	if(callback->req.handle->cache != NULL)
+		_geocoder_cache_store_address(callback->req.handle->cache, callback->latitude, callback->longitude, addr);
+
+	LOGI("[%s] Address - building number: %s, postal code: %s, street: %s, city: %s, district:  %s, state: %s, country code: %s", __FUNCTION__ , addr->building_number, addr->postal_code, addr->street, addr->city, addr->district, addr->state, addr->country_code);
+	__deliver_address(callback, GEOCODER_ERROR_NONE, addr);
+}
+
+static void __cb_address_from_position (LocationError error, LocationAddress *addr, LocationAccuracy *acc, gpointer userdata)
+{
+	__addr_callback_data * callback = (__addr_callback_data*)userdata;
+	if( callback == NULL || callback->callback == NULL)
+	{
+		LOGI("[%s] callback is NULL )",__FUNCTION__);
+		return ;
+	}
+
+	_geocoder_request_lock();
+	__on_address(callback, error, addr, acc);
+	_geocoder_request_unlock();
+}
+
+static void __on_positions(__pos_callback_data *callback, LocationError error, GList *position_list, GList *accuracy_list)
+{
+	if(callback->req.handle == NULL)
+	{
+		/* The handle was destroyed while the request was in flight, nobody is waiting for it any more */
+		__pos_callback_free(callback);
+		return;
+	}
+
+	if(callback->req.handle->trace != NULL)
+		_geocoder_trace_record_position(callback->req.handle->trace, callback->req.issued, callback->address, error, position_list, accuracy_list);
+
+	if(error != LOCATION_ERROR_NONE || position_list == NULL || position_list->data ==NULL || accuracy_list==NULL )
+	{
+		int ret = __convert_error_code(error,(char*)__FUNCTION__);
+		if(ret == GEOCODER_ERROR_NOT_FOUND && callback->parsed != NULL)
+		{
+			/* The parse may have been wrong, let the provider read the address itself; a half-open probe is kept for it */
+			LOGI("[%s] no match for the parsed address, retry freeform", __FUNCTION__);
+			location_address_free(callback->parsed);
+			callback->parsed = NULL;
+			callback->req.retry_id = g_idle_add(__retry_position, callback);
+			return;
+		}
+		__breaker_record(callback->req.handle->breaker, &callback->req, ret);
+		if(__is_transient_error(ret) && __retry_acquire(callback->req.handle, callback->req.attempt))
+		{
+			callback->req.retry_id = g_timeout_add(__retry_delay(callback->req.handle, callback->req.attempt), __retry_position, callback);
+			callback->req.attempt++;
+			return;
+		}
+		__deliver_positions(callback, ret, NULL);
+		return;
+	}
+
+	__breaker_record(callback->req.handle->breaker, &callback->req, GEOCODER_ERROR_NONE);
+	if(callback->req.handle->cache != NULL)
+		_geocoder_cache_store_positions(callback->req.handle->cache, callback->cache_key ? callback->cache_key : callback->address, position_list);
+
+	__deliver_positions(callback, GEOCODER_ERROR_NONE, position_list);
+}
+
+static void __cb_position_from_address (LocationError error, GList *position_list, GList *accuracy_list, gpointer userdata)
+{
+	__pos_callback_data * callback = (__pos_callback_data*)userdata;
+	if( callback == NULL || (callback->callback == NULL && callback->positions_callback == NULL))
+	{
+		LOGI("[%s] callback is NULL )",__FUNCTION__);
+		return ;
+	}
+
+	_geocoder_request_lock();
+	__on_positions(callback, error, position_list, accuracy_list);
+	_geocoder_request_unlock();
+}
+
+typedef struct {
+	void *data;
+	geocoder_suggestion_cb callback;
+	char *prefix;
+	int max_count;
+}__suggest_callback_data;
+
+static void __cb_suggestions_from_provider(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data)
+{
+	__suggest_callback_data *callback = (__suggest_callback_data*)user_data;
+	int i;
+
+	if(result != GEOCODER_ERROR_NONE || count == 0)
+	{
+		callback->callback(result, NULL, 0, 0, callback->data);
+	}
+	else
+	{
+		for(i = 0; i < count && i < callback->max_count; i++)
+		{
+			if(!callback->callback(GEOCODER_ERROR_NONE, callback->prefix, latitudes[i], longitudes[i], callback->data))
+				break;
+		}
+	}
+	g_free(callback->prefix);
 	free(callback);
 }
 
+static void __request_free(gpointer data, gpointer user_data)
+{
+	__request_data *req = (__request_data*)data;
+
+	if(req->retry_id == 0)
+	{
+		/* Still in flight : the backend owns it, just detach it from the handle and drop its probe */
+		__breaker_release(req);
+		req->handle = NULL;
+		return;
+	}
+
+	g_source_remove(req->retry_id);
+	if(req->cached != NULL)
+		_geocoder_completion_free(req->cached);
+	if(req->type != _GEOCODER_CB_ADDRESS_FROM_POSITION)
+		__pos_callback_free((__pos_callback_data*)req);
+	else
+		free(req);
+}
+
+static int __issue_positions(geocoder_s *handle, const char* address, _geocoder_cb_e type, void *callback, void *user_data)
+{
+	__pos_callback_data * calldata = (__pos_callback_data *)malloc(sizeof(__pos_callback_data));
+	if( calldata == NULL)
+	{
+		LOGE("[%s] GEOCODER_ERROR_OUT_OF_MEMORY(0x%08x) : fail to create callback data", __FUNCTION__, GEOCODER_ERROR_OUT_OF_MEMORY);
+		return GEOCODER_ERROR_OUT_OF_MEMORY;
+	}
+	memset(calldata, 0, sizeof(__pos_callback_data));
+	calldata->req.handle = handle;
+	calldata->req.type = type;
+	if(type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+		calldata->positions_callback = (geocoder_get_positions_cb)callback;
+	else
+		calldata->callback = (geocoder_get_position_cb)callback;
+	calldata->data = user_data;
+	calldata->address = g_strdup(address);
+	calldata->parsed = _geocoder_parser_parse(address);
+	if(calldata->parsed != NULL)
+		calldata->cache_key = _geocoder_parser_key(calldata->parsed);
+
+	if(handle->cache != NULL)
+	{
+		geocoder_completion_s *completion = _geocoder_cache_lookup_positions(handle->cache, calldata->cache_key ? calldata->cache_key : address, type);
+		if(completion != NULL)
+		{
+			if(type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+				completion->callback.positions = (geocoder_get_positions_cb)callback;
+			else
+				completion->callback.position = (geocoder_get_position_cb)callback;
+			completion->user_data = user_data;
+			__defer_cached(handle, &calldata->req, completion);
+			return GEOCODER_ERROR_NONE;
+		}
+	}
+
+	if(!__breaker_allow(handle->breaker, &calldata->req))
+	{
+		__pos_callback_free(calldata);
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : provider circuit is open", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+	handle->retry_tokens = MIN(handle->retry_tokens + _GEOCODER_RETRY_BUDGET_RATIO, _GEOCODER_RETRY_BUDGET_MAX);
+	handle->requests = g_list_prepend(handle->requests, calldata);
+
+	int ret;	
+	ret = __request_position(calldata);
+	if( ret != LOCATION_ERROR_NONE)
+	{
+		handle->requests = g_list_remove(handle->requests, calldata);
+		ret = __convert_error_code(ret,(char*)__FUNCTION__);
+		__breaker_record(handle->breaker, &calldata->req, ret);
+		__pos_callback_free(calldata);
+		return ret;
+	}
+	return GEOCODER_ERROR_NONE;
+}
+
+static int __get_positions_from_address(geocoder_s *handle, const char* address, _geocoder_cb_e type, void *callback, void *user_data)
+{
+	int ret;
+
+	_geocoder_request_lock();
+	ret = __issue_positions(handle, address, type, callback, user_data);
+	_geocoder_request_unlock();
+	return ret;
+}
+
+/* Coarse addresses come from the boundaries, when they cover every level asked for; their names are interned */
+static geocoder_completion_s* __region_completion(geocoder_boundary_s *boundary, double latitude, double longitude, geocoder_detail_level_e level, geocoder_get_address_cb callback, void *user_data)
+{
+	const char *names[_GEOCODER_BOUNDARY_LEVEL_NUM];
+	LocationAddress addr;
+
+	if(_geocoder_boundary_lookup(boundary, latitude, longitude, names) == 0
+		|| names[_GEOCODER_BOUNDARY_COUNTRY] == NULL
+		|| (level >= GEOCODER_DETAIL_REGION && names[_GEOCODER_BOUNDARY_STATE] == NULL)
+		|| (level >= GEOCODER_DETAIL_CITY && names[_GEOCODER_BOUNDARY_CITY] == NULL))
+		return NULL;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.country_code = (gchar*)names[_GEOCODER_BOUNDARY_COUNTRY];
+	if(level >= GEOCODER_DETAIL_REGION)
+		addr.state = (gchar*)names[_GEOCODER_BOUNDARY_STATE];
+	if(level >= GEOCODER_DETAIL_CITY)
+	{
+		addr.city = (gchar*)names[_GEOCODER_BOUNDARY_CITY];
+		addr.district = (gchar*)names[_GEOCODER_BOUNDARY_DISTRICT];
+	}
+	return _geocoder_completion_new_interned_address(&addr, callback, user_data);
+}
+
+typedef struct {
+	geocoder_get_address_cb callback;
+	void *user_data;
+	geocoder_completion_s *completion;
+}__tile_address_data;
+
+static bool __cb_tile_address(geocoder_error_e result, double distance, double latitude, double longitude, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	__tile_address_data *data = (__tile_address_data*)user_data;
+	LocationAddress addr;
+
+	/* The strings live in the mapped tile, the completion keeps copies */
+	memset(&addr, 0, sizeof(addr));
+	addr.building_number = (gchar*)building_number;
+	addr.postal_code = (gchar*)postal_code;
+	addr.street = (gchar*)street;
+	addr.city = (gchar*)city;
+	addr.district = (gchar*)district;
+	addr.state = (gchar*)state;
+	addr.country_code = (gchar*)country_code;
+	data->completion = _geocoder_completion_new_address(GEOCODER_ERROR_NONE, &addr, data->callback, data->user_data);
+	return false;
+}
+
+/* Street addresses come from the offline tiles, when one lies close enough to the position */
+static geocoder_completion_s* __tile_completion(geocoder_tiles_s *tiles, double latitude, double longitude, geocoder_get_address_cb callback, void *user_data)
+{
+	__tile_address_data data = { callback, user_data, NULL };
+
+	_geocoder_tiles_nearest(tiles, latitude, longitude, 1, _GEOCODER_TILE_REVERSE_RADIUS, __cb_tile_address, &data);
+	return data.completion;
+}
+
+static int __issue_address(geocoder_s *handle, double latitude, double longitude, geocoder_detail_level_e level, geocoder_get_address_cb callback, void *user_data)
+{
+	int ret;
+
+	__addr_callback_data * calldata = (__addr_callback_data *)malloc(sizeof(__addr_callback_data));
+	if( calldata == NULL)
+	{
+		LOGE("[%s] GEOCODER_ERROR_OUT_OF_MEMORY(0x%08x) : fail to create callback data", __FUNCTION__, GEOCODER_ERROR_OUT_OF_MEMORY);
+		return GEOCODER_ERROR_OUT_OF_MEMORY;
+	}
+	memset(calldata, 0, sizeof(__addr_callback_data));
+	calldata->req.handle = handle;
+	calldata->req.type = _GEOCODER_CB_ADDRESS_FROM_POSITION;
+	calldata->callback = callback;
+	calldata->data = user_data;
+	calldata->latitude = latitude;
+	calldata->longitude = longitude;
+
+	if(level < GEOCODER_DETAIL_STREET && handle->boundary != NULL)
+	{
+		geocoder_completion_s *completion = __region_completion(handle->boundary, latitude, longitude, level, callback, user_data);
+		if(completion != NULL)
+		{
+			__defer_cached(handle, &calldata->req, completion);
+			return GEOCODER_ERROR_NONE;
+		}
+	}
+
+	if(level == GEOCODER_DETAIL_NEARBY_STREET && handle->tiles != NULL)
+	{
+		geocoder_completion_s *completion = __tile_completion(handle->tiles, latitude, longitude, callback, user_data);
+		if(completion != NULL)
+		{
+			__defer_cached(handle, &calldata->req, completion);
+			return GEOCODER_ERROR_NONE;
+		}
+	}
+
+	if(handle->cache != NULL)
+	{
+		geocoder_completion_s *completion = _geocoder_cache_lookup_address(handle->cache, latitude, longitude);
+		if(completion != NULL)
+		{
+			completion->callback.address = callback;
+			completion->user_data = user_data;
+			__defer_cached(handle, &calldata->req, completion);
+			return GEOCODER_ERROR_NONE;
+		}
+	}
+
+	if(!__breaker_allow(handle->breaker, &calldata->req))
+	{
+		free(calldata);
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : provider circuit is open", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+	handle->retry_tokens = MIN(handle->retry_tokens + _GEOCODER_RETRY_BUDGET_RATIO, _GEOCODER_RETRY_BUDGET_MAX);
+	handle->requests = g_list_prepend(handle->requests, calldata);
+
+	ret = __request_address(calldata);
+	if( ret != LOCATION_ERROR_NONE)
+	{
+		handle->requests = g_list_remove(handle->requests, calldata);
+		ret = __convert_error_code(ret,(char*)__FUNCTION__);
+		__breaker_record(handle->breaker, &calldata->req, ret);
+		free(calldata);
+		return ret;
+	}
+	return GEOCODER_ERROR_NONE;
+}
+
+static int __get_address_from_position(geocoder_s *handle, double latitude, double longitude, geocoder_detail_level_e level, geocoder_get_address_cb callback, void *user_data)
+{
+	int ret;
+
+	_geocoder_request_lock();
+	ret = __issue_address(handle, latitude, longitude, level, callback, user_data);
+	_geocoder_request_unlock();
+	return ret;
+}
+
 /*
 * Public Implementation
 */
 int	geocoder_create(geocoder_h* geocoder)
 {
+	GEOCODER_POOL_CHECK();
 	GEOCODER_NULL_ARG_CHECK(geocoder);
 	if(location_init()!=LOCATION_ERROR_NONE)
 	{
@@ -163,37 +893,169 @@ int	geocoder_create(geocoder_h* geocoder)
 		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
 	}
 
+	/* Handles of the same provider share its circuit */
+	gchar *provider = location_map_get_default_provider(handle->object);
+	handle->breaker = __breaker_get(provider);
+	g_free(provider);
+	handle->retry_max = _GEOCODER_RETRY_MAX_DEFAULT;
+	handle->retry_base_delay = _GEOCODER_RETRY_BASE_DELAY_DEFAULT;
+	handle->retry_max_delay = _GEOCODER_RETRY_MAX_DELAY_DEFAULT;
+	handle->retry_tokens = _GEOCODER_RETRY_BUDGET_MAX;
+	handle->event_fd = -1;
+	handle->dispatch = _geocoder_dispatch_new(GEOCODER_DISPATCH_INLINE, NULL);
+	handle->tile_budget = _GEOCODER_TILE_BUDGET_DEFAULT;
+
 	*geocoder = (geocoder_h)handle;
 	return GEOCODER_ERROR_NONE;
 }
 
 int	geocoder_destroy(geocoder_h geocoder)
 {
+	GEOCODER_POOL_CHECK();
 	GEOCODER_NULL_ARG_CHECK(geocoder);
 	geocoder_s *handle = (geocoder_s*)geocoder;
 
+	/* Callbacks already running finish first, later ones find their request detached */
+	_geocoder_request_lock();
 	int ret = location_map_free(handle->object);
 	if(ret!=GEOCODER_ERROR_NONE)
 	{
+		_geocoder_request_unlock();
 		return __convert_error_code(ret,(char*)__FUNCTION__);
 	}
+	g_list_foreach(handle->requests, __request_free, NULL);
+	g_list_free(handle->requests);
+	_geocoder_completion_close(handle);
+	_geocoder_cache_close(handle->cache);
+	_geocoder_trace_close(handle->trace);
+	_geocoder_request_unlock();
+	/* Out of the lock, which the callbacks it waits for may be taking */
+	_geocoder_dispatch_release(handle->dispatch, NULL);
+	_geocoder_gazetteer_free(handle->gazetteer);
+	_geocoder_offline_free(handle->offline);
+	_geocoder_tiles_close(handle->tiles);
+	_geocoder_boundary_free(handle->boundary);
 	free(handle);
 	return GEOCODER_ERROR_NONE;
 }
 
+int	geocoder_set_retry_policy(geocoder_h geocoder, int max_retries, int base_delay, int max_delay)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(max_retries >= 0, GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(base_delay > 0 && max_delay >= base_delay, GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	_geocoder_request_lock();
+	handle->retry_max = max_retries;
+	handle->retry_base_delay = base_delay;
+	handle->retry_max_delay = max_delay;
+	_geocoder_request_unlock();
+	return GEOCODER_ERROR_NONE;
+}
+
 int	geocoder_get_address_from_position(geocoder_h geocoder, double latitude, double longitude, geocoder_get_address_cb callback, void *user_data)
 {
+	GEOCODER_POOL_CHECK();
 	GEOCODER_NULL_ARG_CHECK(geocoder);
 	GEOCODER_NULL_ARG_CHECK(callback);
 	GEOCODER_CHECK_CONDITION(latitude>=-90 && latitude<=90 ,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
 	GEOCODER_CHECK_CONDITION(longitude>=-180 && longitude<=180,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
-	
+
+	return __get_address_from_position((geocoder_s*)geocoder, latitude, longitude, GEOCODER_DETAIL_STREET, callback, user_data);
+}
+
+int	geocoder_get_address_from_position_with_detail(geocoder_h geocoder, double latitude, double longitude, geocoder_detail_level_e level, geocoder_get_address_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(callback);
+	GEOCODER_CHECK_CONDITION(latitude>=-90 && latitude<=90 ,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(longitude>=-180 && longitude<=180,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(level >= GEOCODER_DETAIL_COUNTRY && level <= GEOCODER_DETAIL_NEARBY_STREET, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+
+	return __get_address_from_position((geocoder_s*)geocoder, latitude, longitude, level, callback, user_data);
+}
+
+int	 geocoder_foreach_positions_from_address(geocoder_h geocoder,const char* address, geocoder_get_position_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(address);
+	GEOCODER_NULL_ARG_CHECK(callback);
+
+	return __get_positions_from_address((geocoder_s*)geocoder, address, _GEOCODER_CB_POSITION_FROM_ADDRESS, callback, user_data);
+}
+
+int	geocoder_get_positions_from_address(geocoder_h geocoder, const char* address, geocoder_get_positions_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(address);
+	GEOCODER_NULL_ARG_CHECK(callback);
+
+	return __get_positions_from_address((geocoder_s*)geocoder, address, _GEOCODER_CB_POSITIONS_FROM_ADDRESS, callback, user_data);
+}
+
+int	geocoder_get_fd(geocoder_h geocoder, int *fd)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(fd);
 	geocoder_s *handle = (geocoder_s*)geocoder;
-	int ret;
-	LocationPosition *pos = NULL;
-	pos = location_position_new (0, latitude, longitude, 0, LOCATION_STATUS_2D_FIX);
 
-	__addr_callback_data * calldata = (__addr_callback_data *)malloc(sizeof(__addr_callback_data));
+	_geocoder_request_lock();
+	int ret = _geocoder_completion_open(handle);
+	_geocoder_request_unlock();
+	if(ret != GEOCODER_ERROR_NONE)
+		return ret;
+	*fd = handle->event_fd;
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_dispatch(geocoder_h geocoder, int max_count)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	GEOCODER_CHECK_CONDITION(handle->event_fd >= 0, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER : geocoder_get_fd() is not called");
+
+	_geocoder_completion_dispatch(handle, max_count);
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_set_gazetteer(geocoder_h geocoder, const char *path)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_gazetteer_s *gazetteer = NULL;
+
+	if(path != NULL)
+	{
+		int ret = _geocoder_gazetteer_load(path, &gazetteer);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
+	}
+	_geocoder_gazetteer_free(handle->gazetteer);
+	handle->gazetteer = gazetteer;
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_foreach_suggestions(geocoder_h geocoder, const char *prefix, int max_count, geocoder_suggestion_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(prefix);
+	GEOCODER_NULL_ARG_CHECK(callback);
+	GEOCODER_CHECK_CONDITION(max_count > 0, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	if(handle->gazetteer != NULL && _geocoder_gazetteer_lookup(handle->gazetteer, prefix, max_count, callback, user_data) > 0)
+		return GEOCODER_ERROR_NONE;
+
+	__suggest_callback_data * calldata = (__suggest_callback_data *)malloc(sizeof(__suggest_callback_data));
 	if( calldata == NULL)
 	{
 		LOGE("[%s] GEOCODER_ERROR_OUT_OF_MEMORY(0x%08x) : fail to create callback data", __FUNCTION__, GEOCODER_ERROR_OUT_OF_MEMORY);
@@ -201,41 +1063,248 @@ int	geocoder_get_address_from_position(geocoder_h geocoder, double latitude, dou
 	}
 	calldata->callback = callback;
 	calldata->data = user_data;
-	
-	ret = location_map_get_address_from_position_async(handle->object, pos, __cb_address_from_position, calldata);
-	location_position_free(pos);
-	if( ret != LOCATION_ERROR_NONE)
+	calldata->prefix = g_strdup(prefix);
+	calldata->max_count = max_count;
+
+	int ret = __get_positions_from_address(handle, prefix, _GEOCODER_CB_POSITIONS_FROM_ADDRESS, __cb_suggestions_from_provider, calldata);
+	if(ret != GEOCODER_ERROR_NONE)
 	{
+		g_free(calldata->prefix);
 		free(calldata);
-		return __convert_error_code(ret,(char*)__FUNCTION__);
 	}
+	return ret;
+}
+
+int	geocoder_set_offline_data(geocoder_h geocoder, const char *path)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_offline_s *offline = NULL;
+
+	if(path != NULL)
+	{
+		int ret = _geocoder_offline_load(path, &offline);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
+	}
+	_geocoder_offline_free(handle->offline);
+	handle->offline = offline;
 	return GEOCODER_ERROR_NONE;
 }
 
-int	 geocoder_foreach_positions_from_address(geocoder_h geocoder,const char* address, geocoder_get_position_cb callback, void *user_data)
+int	geocoder_foreach_nearby_addresses(geocoder_h geocoder, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data)
 {
+	GEOCODER_POOL_CHECK();
 	GEOCODER_NULL_ARG_CHECK(geocoder);
-	GEOCODER_NULL_ARG_CHECK(address);
 	GEOCODER_NULL_ARG_CHECK(callback);
+	GEOCODER_CHECK_CONDITION(latitude>=-90 && latitude<=90 ,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(longitude>=-180 && longitude<=180,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(max_count >= 0 && radius >= 0 && (max_count > 0 || radius > 0), GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
 	geocoder_s *handle = (geocoder_s*)geocoder;
+	GEOCODER_CHECK_CONDITION(handle->offline != NULL || handle->tiles != NULL, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, "GEOCODER_ERROR_SERVICE_NOT_AVAILABLE : no offline data");
 
-	char* addr_str = g_strdup(address);
+	int count;
+	if(handle->tiles != NULL)
+		count = _geocoder_tiles_nearest(handle->tiles, latitude, longitude, max_count, radius, callback, user_data);
+	else
+		count = _geocoder_offline_nearest(handle->offline, latitude, longitude, max_count, radius, callback, user_data);
+	if(count == 0)
+		return GEOCODER_ERROR_NOT_FOUND;
+	return GEOCODER_ERROR_NONE;
+}
 
-	__pos_callback_data * calldata = (__pos_callback_data *)malloc(sizeof(__pos_callback_data));
-	if( calldata == NULL)
+int	geocoder_set_offline_tiles(geocoder_h geocoder, const char *directory)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_tiles_s *tiles = NULL;
+
+	if(directory != NULL)
 	{
-		LOGE("[%s] GEOCODER_ERROR_OUT_OF_MEMORY(0x%08x) : fail to create callback data", __FUNCTION__, GEOCODER_ERROR_OUT_OF_MEMORY);
-		return GEOCODER_ERROR_OUT_OF_MEMORY;
+		int ret = _geocoder_tiles_open(directory, handle->tile_budget, &tiles);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
 	}
-	calldata->callback = callback;
-	calldata->data = user_data;
+	_geocoder_tiles_close(handle->tiles);
+	handle->tiles = tiles;
+	return GEOCODER_ERROR_NONE;
+}
 
-	int ret;	
-	ret = location_map_get_position_from_freeformed_address_async(handle->object, addr_str,__cb_position_from_address, calldata);
-	g_free(addr_str);
-	if( ret != LOCATION_ERROR_NONE)
+int	geocoder_set_offline_tile_budget(geocoder_h geocoder, int size)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(size > 0, GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	handle->tile_budget = size;
+	if(handle->tiles != NULL)
+		_geocoder_tiles_set_budget(handle->tiles, size);
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_update_offline_tile(geocoder_h geocoder, const char *tile, const char *path)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(tile);
+	GEOCODER_NULL_ARG_CHECK(path);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	GEOCODER_CHECK_CONDITION(handle->tiles != NULL, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, "GEOCODER_ERROR_SERVICE_NOT_AVAILABLE : no offline tiles");
+
+	return _geocoder_tiles_update(handle->tiles, tile, path);
+}
+
+int	geocoder_export_offline_tiles(geocoder_h geocoder, const char *directory)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(directory);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	GEOCODER_CHECK_CONDITION(handle->offline != NULL, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, "GEOCODER_ERROR_SERVICE_NOT_AVAILABLE : no offline data");
+
+	return _geocoder_tiles_export(handle->offline, directory);
+}
+
+int	geocoder_set_boundary_data(geocoder_h geocoder, const char *path)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_boundary_s *boundary = NULL;
+
+	if(path != NULL)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		int ret = _geocoder_boundary_load(path, &boundary);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
+	}
+	_geocoder_boundary_free(handle->boundary);
+	handle->boundary = boundary;
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_get_region_from_position(geocoder_h geocoder, double latitude, double longitude, geocoder_get_address_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(callback);
+	GEOCODER_CHECK_CONDITION(latitude>=-90 && latitude<=90 ,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(longitude>=-180 && longitude<=180,GEOCODER_ERROR_INVALID_PARAMETER,"GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	GEOCODER_CHECK_CONDITION(handle->boundary != NULL, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, "GEOCODER_ERROR_SERVICE_NOT_AVAILABLE : no boundary data");
+
+	const char *names[_GEOCODER_BOUNDARY_LEVEL_NUM];
+	if(_geocoder_boundary_lookup(handle->boundary, latitude, longitude, names) == 0)
+		return GEOCODER_ERROR_NOT_FOUND;
+
+	callback(GEOCODER_ERROR_NONE, NULL, NULL, NULL, names[_GEOCODER_BOUNDARY_CITY], names[_GEOCODER_BOUNDARY_DISTRICT], names[_GEOCODER_BOUNDARY_STATE], names[_GEOCODER_BOUNDARY_COUNTRY], user_data);
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_parse_address(geocoder_h geocoder, const char *address, geocoder_get_address_cb callback, void *user_data)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(address);
+	GEOCODER_NULL_ARG_CHECK(callback);
+
+	LocationAddress *parsed = _geocoder_parser_parse(address);
+	if(parsed == NULL)
+		return GEOCODER_ERROR_NOT_FOUND;
+
+	callback(GEOCODER_ERROR_NONE, parsed->building_number, parsed->postal_code, parsed->street, parsed->city, parsed->district, parsed->state, parsed->country_code, user_data);
+	location_address_free(parsed);
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_set_shared_cache(geocoder_h geocoder, const char *name, int size)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(name == NULL || (name[0] != '\0' && size > 0), GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_cache_s *cache = NULL;
+
+	if(name != NULL)
+	{
+		int ret = _geocoder_cache_open(name, size, &cache);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
 	}
+	_geocoder_request_lock();
+	_geocoder_cache_close(handle->cache);
+	handle->cache = cache;
+	_geocoder_request_unlock();
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_set_trace(geocoder_h geocoder, geocoder_trace_mode_e mode, const char *path)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(mode >= GEOCODER_TRACE_NONE && mode <= GEOCODER_TRACE_REPLAY_FAST, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(mode == GEOCODER_TRACE_NONE || path != NULL, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+	geocoder_trace_s *trace = NULL;
+	geocoder_trace_s *previous = handle->trace;
+
+	if(mode != GEOCODER_TRACE_NONE)
+	{
+		int ret = _geocoder_trace_open(mode, path, &trace);
+		if(ret != GEOCODER_ERROR_NONE)
+			return ret;
+	}
+	/* Closing answers the pending replays, whose callbacks may already issue requests to the new trace */
+	_geocoder_request_lock();
+	handle->trace = trace;
+	_geocoder_trace_close(previous);
+	_geocoder_request_unlock();
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_set_dispatch_mode(geocoder_h geocoder, geocoder_dispatch_mode_e mode, void *context)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(mode >= GEOCODER_DISPATCH_INLINE && mode <= GEOCODER_DISPATCH_THREAD_POOL, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	GEOCODER_CHECK_CONDITION(mode != GEOCODER_DISPATCH_CONTEXT || context != NULL, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	geocoder_dispatch_s *dispatch = _geocoder_dispatch_new(mode, (GMainContext*)context);
+	if(dispatch == NULL)
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+
+	/* The watchdog carries over, overruns of the callbacks still queued included */
+	_geocoder_dispatch_set_budget(dispatch, _geocoder_dispatch_get_budget(handle->dispatch));
+	_geocoder_dispatch_add_overruns(dispatch, _geocoder_dispatch_get_overruns(handle->dispatch));
+	_geocoder_request_lock();
+	_geocoder_dispatch_release(handle->dispatch, dispatch);
+	handle->dispatch = dispatch;
+	_geocoder_request_unlock();
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_set_callback_budget(geocoder_h geocoder, int budget)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_CHECK_CONDITION(budget >= 0, GEOCODER_ERROR_INVALID_PARAMETER, "GEOCODER_ERROR_INVALID_PARAMETER");
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	_geocoder_dispatch_set_budget(handle->dispatch, budget);
+	return GEOCODER_ERROR_NONE;
+}
+
+int	geocoder_get_callback_overruns(geocoder_h geocoder, int *count)
+{
+	GEOCODER_POOL_CHECK();
+	GEOCODER_NULL_ARG_CHECK(geocoder);
+	GEOCODER_NULL_ARG_CHECK(count);
+	geocoder_s *handle = (geocoder_s*)geocoder;
+
+	*count = _geocoder_dispatch_get_overruns(handle->dispatch);
 	return GEOCODER_ERROR_NONE;
 }
@@ -0,0 +1,441 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Administrative boundaries
+*
+* Polygons are indexed by a packed R-tree bulk loaded with Sort-Tile-Recursive: leaves hold
+* _GEOCODER_RTREE_NODE_SIZE polygons, each upper level groups _GEOCODER_RTREE_NODE_SIZE nodes of the
+* level below, and every level is stored contiguously with the root last.
+*
+* Rings are stored closed (first vertex repeated) as separate x and y arrays, so the crossing
+* number test reads consecutive edges with plain vector loads, four edges at a time.
+*/
+
+#define _GEOCODER_RTREE_NODE_SIZE	16
+
+typedef float __v4sf __attribute__((vector_size(16)));
+typedef int __v4si __attribute__((vector_size(16)));
+
+typedef struct {
+	float min_x;
+	float min_y;
+	float max_x;
+	float max_y;
+}__bbox;
+
+typedef struct {
+	__bbox bbox;
+	int first;		/* first child : a node of the level below, or a polygon for leaves */
+	int count;
+}__rtree_node;
+
+typedef struct {
+	__bbox bbox;
+	_geocoder_boundary_level_e level;
+	const gchar *name;	/* interned */
+	int first_ring;
+	int ring_count;
+}__polygon;
+
+typedef struct {
+	int offset;		/* into the vertex arrays */
+	int count;		/* edges; the ring holds count + 1 vertices */
+}__ring;
+
+struct _geocoder_boundary_s{
+	int polygon_count;
+	__polygon *polygons;
+	__ring *rings;
+	float *xs;
+	float *ys;
+	int node_count;
+	__rtree_node *nodes;
+	int leaf_count;
+	int height;		/* levels of nodes, leaves included */
+};
+
+/*
+* Point in polygon
+*/
+static int __ring_crossings(const float *xs, const float *ys, int count, float px, float py)
+{
+	__v4sf vpx = { px, px, px, px };
+	__v4sf vpy = { py, py, py, py };
+	__v4sf zero = { 0, 0, 0, 0 };
+	__v4si acc = { 0, 0, 0, 0 };
+	int crossings = 0;
+	int j = 0;
+
+	/*
+	* Edge (i, j) crosses the ray to +x when it straddles py and the point is strictly left of it :
+	* (yi > py) != (yj > py) and t > 0 for an upward edge, t < 0 for a downward one, with
+	* t = (xj - xi)(py - yi) - (px - xi)(yj - yi), which avoids the division of the usual intersection
+	* test. Points on an edge shared by two polygons thus belong to exactly one, whatever the ring
+	* orientations : the one to their east, or to their north on a horizontal edge.
+	*/
+	for(; j + 4 <= count; j += 4)
+	{
+		__v4sf xi, yi, xj, yj;
+		memcpy(&xi, xs + j, sizeof(xi));
+		memcpy(&yi, ys + j, sizeof(yi));
+		memcpy(&xj, xs + j + 1, sizeof(xj));
+		memcpy(&yj, ys + j + 1, sizeof(yj));
+
+		__v4si straddle = (yi > vpy) ^ (yj > vpy);
+		__v4sf t = (xj - xi) * (vpy - yi) - (vpx - xi) * (yj - yi);
+		__v4si up = yj > yi;
+		__v4si left = ((t > zero) & up) | ((t < zero) & ~up);
+		acc -= straddle & left;
+	}
+	crossings = acc[0] + acc[1] + acc[2] + acc[3];
+
+	for(; j < count; j++)
+	{
+		float xi = xs[j], yi = ys[j], xj = xs[j + 1], yj = ys[j + 1];
+		float t = (xj - xi) * (py - yi) - (px - xi) * (yj - yi);
+		crossings += ((yi > py) != (yj > py)) && (yj > yi ? t > 0 : t < 0);
+	}
+	return crossings;
+}
+
+static bool __polygon_contains(geocoder_boundary_s *boundary, const __polygon *polygon, float px, float py)
+{
+	int crossings = 0;
+	int i;
+
+	/* Even-odd over every ring, so inner rings are holes */
+	for(i = polygon->first_ring; i < polygon->first_ring + polygon->ring_count; i++)
+	{
+		const __ring *ring = &boundary->rings[i];
+		crossings += __ring_crossings(boundary->xs + ring->offset, boundary->ys + ring->offset, ring->count, px, py);
+	}
+	return crossings & 1;
+}
+
+static bool __bbox_contains(const __bbox *bbox, float px, float py)
+{
+	return px >= bbox->min_x && px <= bbox->max_x && py >= bbox->min_y && py <= bbox->max_y;
+}
+
+/*
+* Load
+*/
+static _geocoder_boundary_level_e __parse_level(const char *level)
+{
+	if(g_ascii_strcasecmp(level, "country") == 0)
+		return _GEOCODER_BOUNDARY_COUNTRY;
+	if(g_ascii_strcasecmp(level, "state") == 0)
+		return _GEOCODER_BOUNDARY_STATE;
+	if(g_ascii_strcasecmp(level, "city") == 0)
+		return _GEOCODER_BOUNDARY_CITY;
+	if(g_ascii_strcasecmp(level, "district") == 0)
+		return _GEOCODER_BOUNDARY_DISTRICT;
+	return _GEOCODER_BOUNDARY_LEVEL_NUM;
+}
+
+/* "lon lat,lon lat,...;lon lat,..." : rings separated by ';' */
+static bool __parse_polygon(gchar *line, __polygon *polygon, GArray *rings, GArray *xs, GArray *ys)
+{
+	gchar **fields = g_strsplit(line, "\t", 3);
+	gchar **ring_texts = NULL;
+	bool ret = false;
+	int i;
+
+	if(g_strv_length(fields) != 3 || (polygon->level = __parse_level(fields[0])) == _GEOCODER_BOUNDARY_LEVEL_NUM || fields[1][0] == '\0')
+	{
+		g_strfreev(fields);
+		return false;
+	}
+
+	polygon->first_ring = rings->len;
+	polygon->ring_count = 0;
+	polygon->bbox.min_x = polygon->bbox.min_y = INFINITY;
+	polygon->bbox.max_x = polygon->bbox.max_y = -INFINITY;
+
+	ring_texts = g_strsplit(fields[2], ";", -1);
+	for(i = 0; ring_texts[i] != NULL; i++)
+	{
+		__ring ring = { xs->len, 0 };
+		gchar *p = ring_texts[i];
+		float first_x = 0, first_y = 0;
+
+		while(*p != '\0')
+		{
+			gchar *end = NULL;
+			float x = g_ascii_strtod(p, &end);
+			if(end == p)
+				break;
+			p = end;
+			float y = g_ascii_strtod(p, &end);
+			if(end == p)
+				break;
+			p = end;
+			while(*p == ',' || *p == ' ')
+				p++;
+
+			if(ring.count == 0)
+			{
+				first_x = x;
+				first_y = y;
+			}
+			g_array_append_val(xs, x);
+			g_array_append_val(ys, y);
+			ring.count++;
+			polygon->bbox.min_x = MIN(polygon->bbox.min_x, x);
+			polygon->bbox.max_x = MAX(polygon->bbox.max_x, x);
+			polygon->bbox.min_y = MIN(polygon->bbox.min_y, y);
+			polygon->bbox.max_y = MAX(polygon->bbox.max_y, y);
+		}
+
+		if(ring.count < 3)
+		{
+			g_array_set_size(xs, ring.offset);
+			g_array_set_size(ys, ring.offset);
+			continue;
+		}
+		/* Close the ring, so that it has as many edges as distinct vertices */
+		if(g_array_index(xs, float, xs->len - 1) != first_x || g_array_index(ys, float, ys->len - 1) != first_y)
+		{
+			g_array_append_val(xs, first_x);
+			g_array_append_val(ys, first_y);
+		}
+		else
+		{
+			ring.count--;
+		}
+		g_array_append_val(rings, ring);
+		polygon->ring_count++;
+	}
+	g_strfreev(ring_texts);
+
+	if(polygon->ring_count > 0)
+	{
+		polygon->name = _geocoder_intern(fields[1]);
+		ret = true;
+	}
+	g_strfreev(fields);
+	return ret;
+}
+
+static int __compare_center_x(const void *a, const void *b)
+{
+	const __bbox *ba = a;
+	const __bbox *bb = b;
+	float ca = ba->min_x + ba->max_x;
+	float cb = bb->min_x + bb->max_x;
+	return (ca > cb) - (ca < cb);
+}
+
+static int __compare_center_y(const void *a, const void *b)
+{
+	const __bbox *ba = a;
+	const __bbox *bb = b;
+	float ca = ba->min_y + ba->max_y;
+	float cb = bb->min_y + bb->max_y;
+	return (ca > cb) - (ca < cb);
+}
+
+/* Sort-Tile-Recursive order : vertical slices by x, each slice by y. Items start with their bbox */
+static void __str_sort(void *items, int count, size_t size)
+{
+	int leaves = (count + _GEOCODER_RTREE_NODE_SIZE - 1) / _GEOCODER_RTREE_NODE_SIZE;
+	int slices = (int)ceil(sqrt((double)leaves));
+	int slice_size = slices * _GEOCODER_RTREE_NODE_SIZE;
+	int i;
+
+	qsort(items, count, size, __compare_center_x);
+	for(i = 0; i < count; i += slice_size)
+		qsort((char*)items + i * size, MIN(slice_size, count - i), size, __compare_center_y);
+}
+
+static void __bbox_extend(__bbox *bbox, const __bbox *other)
+{
+	bbox->min_x = MIN(bbox->min_x, other->min_x);
+	bbox->min_y = MIN(bbox->min_y, other->min_y);
+	bbox->max_x = MAX(bbox->max_x, other->max_x);
+	bbox->max_y = MAX(bbox->max_y, other->max_y);
+}
+
+static void __build(geocoder_boundary_s *boundary)
+{
+	GArray *nodes = g_array_new(FALSE, FALSE, sizeof(__rtree_node));
+	int level_first = 0;
+	int level_count;
+	int i;
+
+	__str_sort(boundary->polygons, boundary->polygon_count, sizeof(__polygon));
+
+	/* Leaves over polygons */
+	for(i = 0; i < boundary->polygon_count; i += _GEOCODER_RTREE_NODE_SIZE)
+	{
+		__rtree_node node = { boundary->polygons[i].bbox, i, MIN(_GEOCODER_RTREE_NODE_SIZE, boundary->polygon_count - i) };
+		int j;
+		for(j = 1; j < node.count; j++)
+			__bbox_extend(&node.bbox, &boundary->polygons[i + j].bbox);
+		g_array_append_val(nodes, node);
+	}
+	boundary->leaf_count = nodes->len;
+	boundary->height = 1;
+	level_count = nodes->len;
+
+	/* Upper levels until a single root */
+	while(level_count > 1)
+	{
+		__str_sort(&g_array_index(nodes, __rtree_node, level_first), level_count, sizeof(__rtree_node));
+		int next_first = nodes->len;
+		for(i = level_first; i < level_first + level_count; i += _GEOCODER_RTREE_NODE_SIZE)
+		{
+			__rtree_node node = { g_array_index(nodes, __rtree_node, i).bbox, i, MIN(_GEOCODER_RTREE_NODE_SIZE, level_first + level_count - i) };
+			int j;
+			for(j = 1; j < node.count; j++)
+				__bbox_extend(&node.bbox, &g_array_index(nodes, __rtree_node, i + j).bbox);
+			g_array_append_val(nodes, node);
+		}
+		level_first = next_first;
+		level_count = nodes->len - next_first;
+		boundary->height++;
+	}
+
+	boundary->node_count = nodes->len;
+	boundary->nodes = (__rtree_node*)g_array_free(nodes, FALSE);
+}
+
+int _geocoder_boundary_load(const char *path, geocoder_boundary_s **boundary)
+{
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+	GArray *polygons, *rings, *xs, *ys;
+	gchar *line;
+	gchar *next;
+
+	if(!g_file_get_contents(path, &contents, &length, &error))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to read %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		g_error_free(error);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	polygons = g_array_new(FALSE, FALSE, sizeof(__polygon));
+	rings = g_array_new(FALSE, FALSE, sizeof(__ring));
+	xs = g_array_new(FALSE, FALSE, sizeof(float));
+	ys = g_array_new(FALSE, FALSE, sizeof(float));
+	for(line = contents; line != NULL && *line != '\0'; line = next)
+	{
+		__polygon polygon;
+		next = strchr(line, '\n');
+		if(next != NULL)
+			*next++ = '\0';
+		g_strchomp(line);
+		if(line[0] == '#' || line[0] == '\0')
+			continue;
+		if(__parse_polygon(line, &polygon, rings, xs, ys))
+			g_array_append_val(polygons, polygon);
+		else
+			LOGI("[%s] skip invalid polygon", __FUNCTION__);
+	}
+	g_free(contents);
+
+	if(polygons->len == 0)
+	{
+		g_array_free(polygons, TRUE);
+		g_array_free(rings, TRUE);
+		g_array_free(xs, TRUE);
+		g_array_free(ys, TRUE);
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : no polygon in %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	*boundary = g_new0(geocoder_boundary_s, 1);
+	(*boundary)->polygon_count = polygons->len;
+	(*boundary)->polygons = (__polygon*)g_array_free(polygons, FALSE);
+	(*boundary)->rings = (__ring*)g_array_free(rings, FALSE);
+	(*boundary)->xs = (float*)g_array_free(xs, FALSE);
+	(*boundary)->ys = (float*)g_array_free(ys, FALSE);
+	__build(*boundary);
+	LOGI("[%s] %d polygons, %d nodes", __FUNCTION__, (*boundary)->polygon_count, (*boundary)->node_count);
+	return GEOCODER_ERROR_NONE;
+}
+
+void _geocoder_boundary_free(geocoder_boundary_s *boundary)
+{
+	if(boundary == NULL)
+		return;
+	g_free(boundary->polygons);
+	g_free(boundary->rings);
+	g_free(boundary->xs);
+	g_free(boundary->ys);
+	g_free(boundary->nodes);
+	g_free(boundary);
+}
+
+/*
+* Lookup
+*/
+int _geocoder_boundary_lookup(geocoder_boundary_s *boundary, double latitude, double longitude, const char **names)
+{
+	/* Each level down leaves at most the siblings of the node descended into */
+	int *stack = g_newa(int, boundary->height * (_GEOCODER_RTREE_NODE_SIZE - 1) + 1);
+	int top = 0;
+	int found = 0;
+	float px = longitude;
+	float py = latitude;
+	int i;
+
+	for(i = 0; i < _GEOCODER_BOUNDARY_LEVEL_NUM; i++)
+		names[i] = NULL;
+
+	stack[top++] = boundary->node_count - 1;
+	while(top > 0)
+	{
+		const __rtree_node *node = &boundary->nodes[stack[--top]];
+		if(!__bbox_contains(&node->bbox, px, py))
+			continue;
+
+		if(node - boundary->nodes >= boundary->leaf_count)
+		{
+			for(i = node->first; i < node->first + node->count; i++)
+				stack[top++] = i;
+			continue;
+		}
+
+		for(i = node->first; i < node->first + node->count; i++)
+		{
+			const __polygon *polygon = &boundary->polygons[i];
+			if(names[polygon->level] != NULL || !__bbox_contains(&polygon->bbox, px, py))
+				continue;
+			if(__polygon_contains(boundary, polygon, px, py))
+			{
+				names[polygon->level] = polygon->name;
+				found++;
+			}
+		}
+	}
+	return found;
+}
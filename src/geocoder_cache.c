@@ -0,0 +1,458 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Shared cache
+*
+* A named POSIX shared memory segment holds a header and an array of fixed size slots, and every
+* process mapping the same name shares the entries. The slot count follows from the segment size,
+* so processes agree on the geometry without any initialisation step beyond the magic number. Only
+* the process creating the segment sizes it, so a mapping never shrinks under another process.
+*
+* Keys hash to a window of _GEOCODER_CACHE_PROBE consecutive slots. A store takes the slot already
+* holding the key, or an empty one, or the oldest one of the window.
+*
+* Every slot is guarded by a sequence lock: a writer makes the sequence odd with a compare and
+* swap, so concurrent writers of the same slot give up instead of waiting, writes the entry and
+* makes the sequence even again. A reader copies the slot and keeps the copy only if the sequence
+* was even and unchanged around the copy. A writer dying in between leaves its slot unusable,
+* not corrupt.
+*/
+
+#define _GEOCODER_CACHE_MAGIC	0x47454f31	/* "GEO1" */
+#define _GEOCODER_CACHE_SLOT_SIZE	512
+#define _GEOCODER_CACHE_PROBE	8
+#define _GEOCODER_CACHE_TTL	(24 * 60 * 60)	/* seconds */
+#define _GEOCODER_CACHE_MIN_SLOTS	16
+#define _GEOCODER_CACHE_MAX_POSITIONS	16
+
+typedef enum {
+	__CACHE_EMPTY,
+	__CACHE_ADDRESS,
+	__CACHE_POSITIONS
+}__cache_kind;
+
+typedef struct {
+	guint32 magic;
+	guint8 reserved[60];
+}__cache_header;
+
+#define _GEOCODER_CACHE_DATA_SIZE	(_GEOCODER_CACHE_SLOT_SIZE - 32)
+
+typedef struct {
+	gint seq;
+	guint32 kind;
+	guint64 hash;
+	gint64 stored_at;	/* wall clock seconds, comparable across processes */
+	guint16 key_len;
+	guint16 value_len;
+	guint32 reserved;
+	guint8 data[_GEOCODER_CACHE_DATA_SIZE];	/* key, then value */
+}__cache_slot;
+
+struct _geocoder_cache_s{
+	void *base;
+	gsize size;
+	__cache_slot *slots;
+	guint slot_count;
+};
+
+/*
+* Keys and values
+*/
+static guint64 __hash(guint32 kind, const guint8 *key, gsize key_len)
+{
+	/* FNV-1a, 64 bits */
+	guint64 hash = 14695981039346656037ULL ^ kind;
+	gsize i;
+	for(i = 0; i < key_len; i++)
+	{
+		hash ^= key[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* Positions are keyed to the microdegree */
+static void __position_key(double latitude, double longitude, guint8 *key)
+{
+	gint32 lat = (gint32)lround(latitude * 1e6);
+	gint32 lon = (gint32)lround(longitude * 1e6);
+	memcpy(key, &lat, sizeof(lat));
+	memcpy(key + sizeof(lat), &lon, sizeof(lon));
+}
+
+/* Addresses are keyed case and normalisation insensitively */
+static gchar* __address_key(const char *address)
+{
+	gchar *normalized = g_utf8_normalize(address, -1, G_NORMALIZE_ALL);
+	if(normalized == NULL)
+		return NULL;
+	gchar *key = g_utf8_casefold(normalized, -1);
+	g_free(normalized);
+	return key;
+}
+
+/* Strings are stored as a length byte and the bytes, 0xff standing for NULL */
+static bool __put_string(guint8 *buffer, gsize size, gsize *offset, const char *str)
+{
+	gsize len = str != NULL ? strlen(str) : 0;
+
+	if(len >= 0xff || *offset + 1 + len > size)
+		return false;
+	buffer[(*offset)++] = str != NULL ? (guint8)len : 0xff;
+	memcpy(buffer + *offset, str, len);
+	*offset += len;
+	return true;
+}
+
+static bool __get_string(const guint8 *buffer, gsize size, gsize *offset, char *out, char **value)
+{
+	if(*offset >= size)
+		return false;
+	guint8 len = buffer[(*offset)++];
+	if(len == 0xff)
+	{
+		*value = NULL;
+		return true;
+	}
+	if(*offset + len > size)
+		return false;
+	memcpy(out, buffer + *offset, len);
+	out[len] = '\0';
+	*offset += len;
+	*value = out;
+	return true;
+}
+
+/*
+* Slots
+*/
+/* Copies the slot if it holds hash; a hash torn by a concurrent writer only costs a miss or a copy thrown away */
+static bool __read_slot(__cache_slot *slot, guint64 hash, __cache_slot *copy)
+{
+	gint seq = g_atomic_int_get(&slot->seq);
+	if((seq & 1) || slot->hash != hash)
+		return false;
+	memcpy(copy, slot, sizeof(*copy));
+	__sync_synchronize();
+	return g_atomic_int_get(&slot->seq) == seq;
+}
+
+/* The fields a store chooses its slot by, with the sequence they were read at, odd if they could not be read */
+static gint __read_header(__cache_slot *slot, guint32 *kind, guint64 *hash, gint64 *stored_at)
+{
+	gint seq = g_atomic_int_get(&slot->seq);
+	if(seq & 1)
+		return seq;
+	*kind = slot->kind;
+	*hash = slot->hash;
+	*stored_at = slot->stored_at;
+	__sync_synchronize();
+	return g_atomic_int_get(&slot->seq) == seq ? seq : 1;
+}
+
+static bool __fresh(const __cache_slot *slot, gint64 now)
+{
+	return slot->stored_at <= now && now - slot->stored_at < _GEOCODER_CACHE_TTL;
+}
+
+static bool __lookup(geocoder_cache_s *cache, guint32 kind, const guint8 *key, gsize key_len, __cache_slot *found)
+{
+	guint64 hash = __hash(kind, key, key_len);
+	gint64 now = time(NULL);
+	int i;
+
+	for(i = 0; i < _GEOCODER_CACHE_PROBE; i++)
+	{
+		__cache_slot *slot = &cache->slots[(hash + i) % cache->slot_count];
+		if(!__read_slot(slot, hash, found))
+			continue;
+		if(found->kind == kind && found->hash == hash && found->key_len == key_len
+			&& key_len + found->value_len <= _GEOCODER_CACHE_DATA_SIZE
+			&& memcmp(found->data, key, key_len) == 0 && __fresh(found, now))
+			return true;
+	}
+	return false;
+}
+
+static void __store(geocoder_cache_s *cache, guint32 kind, const guint8 *key, gsize key_len, const guint8 *value, gsize value_len)
+{
+	guint64 hash = __hash(kind, key, key_len);
+	gint64 now = time(NULL);
+	__cache_slot *victim = NULL;
+	guint32 victim_kind = __CACHE_EMPTY;
+	gint64 victim_stored_at = 0;
+	gint seq = 0;
+	int i;
+
+	if(key_len + value_len > _GEOCODER_CACHE_DATA_SIZE)
+		return;
+
+	for(i = 0; i < _GEOCODER_CACHE_PROBE; i++)
+	{
+		__cache_slot *slot = &cache->slots[(hash + i) % cache->slot_count];
+		guint32 slot_kind;
+		guint64 slot_hash;
+		gint64 slot_stored_at;
+		gint slot_seq = __read_header(slot, &slot_kind, &slot_hash, &slot_stored_at);
+		bool take;
+
+		/* Being written by someone else */
+		if(slot_seq & 1)
+			continue;
+		if(slot_hash == hash && slot_kind == kind)
+			take = true;
+		else if(slot_kind == __CACHE_EMPTY)
+			take = (victim == NULL || victim_kind != __CACHE_EMPTY);
+		else
+			take = (victim == NULL || (victim_kind != __CACHE_EMPTY && slot_stored_at < victim_stored_at));
+		if(take)
+		{
+			victim = slot;
+			victim_kind = slot_kind;
+			victim_stored_at = slot_stored_at;
+			seq = slot_seq;
+			if(slot_hash == hash && slot_kind == kind)
+				break;
+		}
+	}
+
+	/* The slot must still be as it was chosen */
+	if(victim == NULL || !g_atomic_int_compare_and_exchange(&victim->seq, seq, seq + 1))
+		return;
+	victim->kind = kind;
+	victim->hash = hash;
+	victim->stored_at = now;
+	victim->key_len = key_len;
+	victim->value_len = value_len;
+	memcpy(victim->data, key, key_len);
+	memcpy(victim->data + key_len, value, value_len);
+	__sync_synchronize();
+	g_atomic_int_set(&victim->seq, seq + 2);
+}
+
+/*
+* Segment
+*/
+int _geocoder_cache_open(const char *name, gsize max_size, geocoder_cache_s **cache)
+{
+	gchar *shm_name = name[0] == '/' ? g_strdup(name) : g_strconcat("/", name, NULL);
+	gsize slot_count = (max_size - MIN(max_size, sizeof(__cache_header))) / sizeof(__cache_slot);
+	gsize size = sizeof(__cache_header) + slot_count * sizeof(__cache_slot);
+	struct stat st;
+	void *base;
+	int fd;
+
+	if(slot_count < _GEOCODER_CACHE_MIN_SLOTS || strchr(shm_name + 1, '/') != NULL)
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : invalid name or size", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER);
+		g_free(shm_name);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if(fd >= 0)
+	{
+		if(ftruncate(fd, size) != 0)
+		{
+			close(fd);
+			fd = -1;
+			shm_unlink(shm_name);
+		}
+	}
+	else
+	{
+		fd = shm_open(shm_name, O_RDWR, 0);
+	}
+	g_free(shm_name);
+	if(fd < 0)
+	{
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : fail to shm_open %s", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, name);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+
+	/* Another process may have created the segment and not sized it yet */
+	int tries;
+	for(tries = 0; fstat(fd, &st) == 0 && st.st_size == 0 && tries < 50; tries++)
+		g_usleep(1000);
+	if(st.st_size < (off_t)(sizeof(__cache_header) + _GEOCODER_CACHE_MIN_SLOTS * sizeof(__cache_slot)))
+	{
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : fail to size %s", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, name);
+		close(fd);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+	size = st.st_size;
+
+	base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(base == MAP_FAILED)
+	{
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : fail to map %s", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, name);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+
+	__cache_header *header = base;
+	if(!g_atomic_int_compare_and_exchange((gint*)&header->magic, 0, _GEOCODER_CACHE_MAGIC) && header->magic != _GEOCODER_CACHE_MAGIC)
+	{
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : %s is not a geocoder cache", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, name);
+		munmap(base, size);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+
+	*cache = g_new0(geocoder_cache_s, 1);
+	(*cache)->base = base;
+	(*cache)->size = size;
+	(*cache)->slots = (__cache_slot*)((guint8*)base + sizeof(__cache_header));
+	(*cache)->slot_count = (size - sizeof(__cache_header)) / sizeof(__cache_slot);
+	LOGI("[%s] %s : %u slots", __FUNCTION__, name, (*cache)->slot_count);
+	return GEOCODER_ERROR_NONE;
+}
+
+void _geocoder_cache_close(geocoder_cache_s *cache)
+{
+	if(cache == NULL)
+		return;
+	munmap(cache->base, cache->size);
+	g_free(cache);
+}
+
+/*
+* Entries
+*/
+geocoder_completion_s* _geocoder_cache_lookup_address(geocoder_cache_s *cache, double latitude, double longitude)
+{
+	guint8 key[8];
+	__cache_slot slot;
+	char fields[7][256];
+	char *values[7];
+	gsize offset;
+	int i;
+
+	__position_key(latitude, longitude, key);
+	if(!__lookup(cache, __CACHE_ADDRESS, key, sizeof(key), &slot))
+		return NULL;
+
+	offset = slot.key_len;
+	for(i = 0; i < 7; i++)
+	{
+		if(!__get_string(slot.data, slot.key_len + slot.value_len, &offset, fields[i], &values[i]))
+			return NULL;
+	}
+
+	LocationAddress addr = {
+		.building_number = values[0], .postal_code = values[1], .street = values[2], .city = values[3],
+		.district = values[4], .state = values[5], .country_code = values[6]
+	};
+	return _geocoder_completion_new_address(GEOCODER_ERROR_NONE, &addr, NULL, NULL);
+}
+
+void _geocoder_cache_store_address(geocoder_cache_s *cache, double latitude, double longitude, const LocationAddress *addr)
+{
+	guint8 buffer[_GEOCODER_CACHE_DATA_SIZE];
+	gsize offset = 8;
+
+	__position_key(latitude, longitude, buffer);
+	if(__put_string(buffer, sizeof(buffer), &offset, addr->building_number)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->postal_code)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->street)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->city)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->district)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->state)
+		&& __put_string(buffer, sizeof(buffer), &offset, addr->country_code))
+		__store(cache, __CACHE_ADDRESS, buffer, 8, buffer + 8, offset - 8);
+}
+
+geocoder_completion_s* _geocoder_cache_lookup_positions(geocoder_cache_s *cache, const char *address, _geocoder_cb_e type)
+{
+	gchar *key = __address_key(address);
+	geocoder_completion_s *completion;
+	__cache_slot slot;
+	guint8 count;
+	int i;
+
+	if(key == NULL || !__lookup(cache, __CACHE_POSITIONS, (const guint8*)key, strlen(key), &slot))
+	{
+		g_free(key);
+		return NULL;
+	}
+	g_free(key);
+
+	const guint8 *value = slot.data + slot.key_len;
+	count = value[0];
+	if(slot.value_len != 1 + count * 2 * sizeof(double) || count == 0)
+		return NULL;
+
+	completion = _geocoder_completion_new_positions(GEOCODER_ERROR_NONE, NULL, type, NULL, NULL);
+	completion->count = count;
+	completion->latitudes = g_new(double, count);
+	completion->longitudes = g_new(double, count);
+	for(i = 0; i < count; i++)
+	{
+		memcpy(&completion->latitudes[i], value + 1 + (2 * i) * sizeof(double), sizeof(double));
+		memcpy(&completion->longitudes[i], value + 1 + (2 * i + 1) * sizeof(double), sizeof(double));
+	}
+	return completion;
+}
+
+void _geocoder_cache_store_positions(geocoder_cache_s *cache, const char *address, GList *position_list)
+{
+	guint8 value[1 + _GEOCODER_CACHE_MAX_POSITIONS * 2 * sizeof(double)];
+	guint8 buffer[_GEOCODER_CACHE_DATA_SIZE];
+	gchar *key;
+	gsize key_len;
+	int count = 0;
+
+	for(; position_list != NULL && count < _GEOCODER_CACHE_MAX_POSITIONS; position_list = g_list_next(position_list), count++)
+	{
+		LocationPosition *pos = position_list->data;
+		memcpy(value + 1 + (2 * count) * sizeof(double), &pos->latitude, sizeof(double));
+		memcpy(value + 1 + (2 * count + 1) * sizeof(double), &pos->longitude, sizeof(double));
+	}
+	/* A truncated list would answer differently from the provider */
+	if(count == 0 || position_list != NULL)
+		return;
+	value[0] = count;
+
+	key = __address_key(address);
+	if(key == NULL)
+		return;
+	key_len = strlen(key);
+	if(key_len + 1 + count * 2 * sizeof(double) <= sizeof(buffer))
+	{
+		memcpy(buffer, key, key_len);
+		memcpy(buffer + key_len, value, 1 + count * 2 * sizeof(double));
+		__store(cache, __CACHE_POSITIONS, buffer, key_len, buffer + key_len, 1 + count * 2 * sizeof(double));
+	}
+	g_free(key);
+}
@@ -0,0 +1,270 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License. 
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Completion records
+*
+* The state and the country code are interned whatever the source of the address : they take few
+* distinct values, so the results of every request, the shared cache's included, share one copy.
+*/
+geocoder_completion_s* _geocoder_completion_new_address(int error, const LocationAddress *addr, geocoder_get_address_cb callback, void *user_data)
+{
+	geocoder_completion_s *completion = g_new0(geocoder_completion_s, 1);
+	completion->type = _GEOCODER_CB_ADDRESS_FROM_POSITION;
+	completion->error = error;
+	completion->callback.address = callback;
+	completion->user_data = user_data;
+	if(addr != NULL)
+	{
+		completion->building_number = g_strdup(addr->building_number);
+		completion->postal_code = g_strdup(addr->postal_code);
+		completion->street = g_strdup(addr->street);
+		completion->city = g_strdup(addr->city);
+		completion->district = g_strdup(addr->district);
+		completion->state = _geocoder_intern(addr->state);
+		completion->country_code = _geocoder_intern(addr->country_code);
+	}
+	return completion;
+}
+
+/* Every string of addr must come from _geocoder_intern(), the completion keeps the pointers */
+geocoder_completion_s* _geocoder_completion_new_interned_address(const LocationAddress *addr, geocoder_get_address_cb callback, void *user_data)
+{
+	geocoder_completion_s *completion = g_new0(geocoder_completion_s, 1);
+	completion->type = _GEOCODER_CB_ADDRESS_FROM_POSITION;
+	completion->error = GEOCODER_ERROR_NONE;
+	completion->callback.address = callback;
+	completion->user_data = user_data;
+	completion->interned = true;
+	completion->building_number = addr->building_number;
+	completion->postal_code = addr->postal_code;
+	completion->street = addr->street;
+	completion->city = addr->city;
+	completion->district = addr->district;
+	completion->state = addr->state;
+	completion->country_code = addr->country_code;
+	return completion;
+}
+
+geocoder_completion_s* _geocoder_completion_new_positions(int error, GList *position_list, _geocoder_cb_e type, void *callback, void *user_data)
+{
+	geocoder_completion_s *completion = g_new0(geocoder_completion_s, 1);
+	int i = 0;
+
+	completion->type = type;
+	completion->error = error;
+	if(type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+		completion->callback.positions = (geocoder_get_positions_cb)callback;
+	else
+		completion->callback.position = (geocoder_get_position_cb)callback;
+	completion->user_data = user_data;
+	if(position_list != NULL)
+	{
+		completion->count = g_list_length(position_list);
+		completion->latitudes = g_new(double, completion->count);
+		completion->longitudes = g_new(double, completion->count);
+		for(; position_list != NULL; position_list = g_list_next(position_list), i++)
+		{
+			LocationPosition *pos = position_list->data;
+			completion->latitudes[i] = pos->latitude;
+			completion->longitudes[i] = pos->longitude;
+		}
+	}
+	return completion;
+}
+
+void _geocoder_completion_invoke(geocoder_completion_s *completion)
+{
+	int i;
+
+	if(completion->type == _GEOCODER_CB_ADDRESS_FROM_POSITION)
+	{
+		completion->callback.address(completion->error, completion->building_number, completion->postal_code, completion->street, completion->city, completion->district, completion->state, completion->country_code, completion->user_data);
+		return;
+	}
+
+	if(completion->type == _GEOCODER_CB_POSITIONS_FROM_ADDRESS)
+	{
+		completion->callback.positions(completion->error, completion->count, completion->latitudes, completion->longitudes, completion->user_data);
+		return;
+	}
+
+	if(completion->error != GEOCODER_ERROR_NONE || completion->count == 0)
+	{
+		completion->callback.position(completion->error, 0, 0, completion->user_data);
+		return;
+	}
+	for(i = 0; i < completion->count; i++)
+	{
+		if(completion->callback.position(GEOCODER_ERROR_NONE, completion->latitudes[i], completion->longitudes[i], completion->user_data) != TRUE)
+		{
+			LOGI("[%s] User quit the loop ",  __FUNCTION__);
+			break;
+		}
+	}
+}
+
+void _geocoder_completion_free(geocoder_completion_s *completion)
+{
+	if(!completion->interned)
+	{
+		g_free(completion->building_number);
+		g_free(completion->postal_code);
+		g_free(completion->street);
+		g_free(completion->city);
+		g_free(completion->district);
+	}
+	g_free(completion->latitudes);
+	g_free(completion->longitudes);
+	g_free(completion);
+}
+
+/*
+* Completion queue
+*
+* Producers push onto an intrusive lock-free stack. The dispatching thread takes the whole
+* stack at once and reverses it into its private FIFO, so only one side ever walks the list.
+*/
+int _geocoder_completion_open(geocoder_s *handle)
+{
+	if(handle->event_fd >= 0)
+		return GEOCODER_ERROR_NONE;
+
+	int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(fd < 0)
+	{
+		LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : fail to create eventfd (%d)", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE, errno);
+		return GEOCODER_ERROR_SERVICE_NOT_AVAILABLE;
+	}
+	g_atomic_int_set(&handle->event_fd, fd);
+	return GEOCODER_ERROR_NONE;
+}
+
+static void __completion_signal(geocoder_s *handle)
+{
+	uint64_t one = 1;
+	if(write(handle->event_fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN)
+	{
+		LOGE("[%s] fail to signal eventfd (%d)", __FUNCTION__, errno);
+	}
+}
+
+void _geocoder_completion_push(geocoder_s *handle, geocoder_completion_s *completion)
+{
+	geocoder_completion_s *head;
+
+	do {
+		head = g_atomic_pointer_get(&handle->completion_head);
+		completion->next = head;
+	} while(!g_atomic_pointer_compare_and_exchange(&handle->completion_head, head, completion));
+
+	/* Only the push onto an empty stack needs to wake the application up */
+	if(head == NULL)
+		__completion_signal(handle);
+}
+
+static geocoder_completion_s* __completion_take_all(geocoder_s *handle)
+{
+	geocoder_completion_s *head;
+	geocoder_completion_s *fifo = NULL;
+
+	do {
+		head = g_atomic_pointer_get(&handle->completion_head);
+	} while(head != NULL && !g_atomic_pointer_compare_and_exchange(&handle->completion_head, head, NULL));
+
+	while(head != NULL)
+	{
+		geocoder_completion_s *next = head->next;
+		head->next = fifo;
+		fifo = head;
+		head = next;
+	}
+	return fifo;
+}
+
+int _geocoder_completion_dispatch(geocoder_s *handle, int max_count)
+{
+	uint64_t value;
+	int dispatched = 0;
+
+	/* Drain the counter before taking the stack, so a later push always signals again */
+	if(read(handle->event_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+	{
+		LOGE("[%s] fail to read eventfd (%d)", __FUNCTION__, errno);
+	}
+
+	if(handle->completion_pending == NULL)
+	{
+		handle->completion_pending = __completion_take_all(handle);
+	}
+	else
+	{
+		geocoder_completion_s *tail = handle->completion_pending;
+		while(tail->next != NULL)
+			tail = tail->next;
+		tail->next = __completion_take_all(handle);
+	}
+
+	while(handle->completion_pending != NULL && (max_count <= 0 || dispatched < max_count))
+	{
+		geocoder_completion_s *completion = handle->completion_pending;
+		handle->completion_pending = completion->next;
+		_geocoder_dispatch_run(handle->dispatch, completion);
+		dispatched++;
+	}
+
+	if(handle->completion_pending != NULL)
+		__completion_signal(handle);
+	return dispatched;
+}
+
+void _geocoder_completion_close(geocoder_s *handle)
+{
+	geocoder_completion_s *completion;
+
+	if(handle->event_fd < 0)
+		return;
+
+	while((completion = handle->completion_pending) != NULL)
+	{
+		handle->completion_pending = completion->next;
+		_geocoder_completion_free(completion);
+	}
+	completion = __completion_take_all(handle);
+	while(completion != NULL)
+	{
+		geocoder_completion_s *next = completion->next;
+		_geocoder_completion_free(completion);
+		completion = next;
+	}
+	close(handle->event_fd);
+	handle->event_fd = -1;
+}
@@ -0,0 +1,292 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Callback dispatch
+*
+* Results leaving the backend's context are flattened into completion records and handed to the
+* context the application chose. Every record in flight holds a reference on the dispatcher, so
+* the dispatcher, and the watchdog counters in it, outlive the handle until the last callback ran.
+*
+* Records still queued when the handle is destroyed are freed without being invoked. Callbacks run
+* under the read side of a lock, whose write side the destruction takes, so none is running on
+* another thread once geocoder_destroy() returns. A dispatcher replaced by another one keeps running
+* its queue, and passes the overruns counted meanwhile on to its successor; both share the lock, so
+* destroying the handle also silences the queue of the former.
+*/
+
+#define _GEOCODER_DISPATCH_THREADS	4
+
+/* Set while a pool thread invokes a callback; pool threads may be reused by other pools in between */
+static GPrivate __pool_callback = G_PRIVATE_INIT(NULL);
+/* The gate of the callback the thread is invoking, if any */
+static GPrivate __running = G_PRIVATE_INIT(NULL);
+
+/* Shared by the successive dispatchers of a handle */
+typedef struct {
+	gint ref;
+	GRWLock lock;		/* read : a queued callback is running, write : releasing */
+	gint released;		/* the handle is destroyed, queued records are dropped */
+}__dispatch_gate;
+
+struct _geocoder_dispatch_s{
+	gint ref;
+	geocoder_dispatch_mode_e mode;
+	GMainContext *context;
+	GThreadPool *pool;
+	gint budget;		/* ms, 0 : no watchdog */
+	gint overruns;
+	__dispatch_gate *gate;
+	struct _geocoder_dispatch_s *successor;	/* replaced by it, which gets the later overruns */
+	gint overruns_at_release;
+};
+
+typedef struct {
+	geocoder_dispatch_s *dispatch;
+	geocoder_completion_s *completion;
+}__dispatch_task;
+
+static const char* __type_name(_geocoder_cb_e type)
+{
+	switch(type)
+	{
+		case _GEOCODER_CB_ADDRESS_FROM_POSITION:
+			return "address";
+		case _GEOCODER_CB_POSITION_FROM_ADDRESS:
+		case _GEOCODER_CB_POSITIONS_FROM_ADDRESS:
+			return "position";
+		default:
+			return "unknown";
+	}
+}
+
+void _geocoder_dispatch_watch(geocoder_dispatch_s *dispatch, _geocoder_cb_e type, gint64 started)
+{
+	gint budget = g_atomic_int_get(&dispatch->budget);
+	if(budget <= 0)
+		return;
+
+	gint64 elapsed = (g_get_monotonic_time() - started) / 1000;
+	if(elapsed > budget)
+	{
+		g_atomic_int_inc(&dispatch->overruns);
+		LOGW("[%s] %s callback took %lld ms, over the budget of %d ms", __FUNCTION__, __type_name(type), (long long)elapsed, budget);
+	}
+}
+
+/* The callback may destroy the handle, so the dispatcher is held until it returns */
+void _geocoder_dispatch_run(geocoder_dispatch_s *dispatch, geocoder_completion_s *completion)
+{
+	gint64 started = g_get_monotonic_time();
+	_geocoder_cb_e type = completion->type;
+
+	_geocoder_dispatch_ref(dispatch);
+	_geocoder_completion_invoke(completion);
+	_geocoder_completion_free(completion);
+	_geocoder_dispatch_watch(dispatch, type, started);
+	_geocoder_dispatch_unref(dispatch);
+}
+
+bool _geocoder_dispatch_is_inline(geocoder_dispatch_s *dispatch)
+{
+	return dispatch->mode == GEOCODER_DISPATCH_INLINE;
+}
+
+static void __gate_unref(__dispatch_gate *gate)
+{
+	if(!g_atomic_int_dec_and_test(&gate->ref))
+		return;
+	g_rw_lock_clear(&gate->lock);
+	g_free(gate);
+}
+
+static void __task_run(__dispatch_task *task)
+{
+	geocoder_dispatch_s *dispatch = task->dispatch;
+	__dispatch_gate *gate = dispatch->gate;
+	gpointer outer = g_private_get(&__running);
+
+	g_rw_lock_reader_lock(&gate->lock);
+	if(g_atomic_int_get(&gate->released))
+	{
+		_geocoder_completion_free(task->completion);
+	}
+	else
+	{
+		g_private_set(&__running, gate);
+		_geocoder_dispatch_run(dispatch, task->completion);
+		g_private_set(&__running, outer);
+	}
+	g_rw_lock_reader_unlock(&gate->lock);
+	_geocoder_dispatch_unref(dispatch);
+	g_free(task);
+}
+
+static gboolean __context_run(gpointer data)
+{
+	__task_run(data);
+	return FALSE;
+}
+
+static void __pool_run(gpointer data, gpointer user_data)
+{
+	g_private_set(&__pool_callback, GINT_TO_POINTER(1));
+	__task_run(data);
+	g_private_set(&__pool_callback, NULL);
+}
+
+bool _geocoder_dispatch_in_pool(void)
+{
+	return g_private_get(&__pool_callback) != NULL;
+}
+
+void _geocoder_dispatch_post(geocoder_dispatch_s *dispatch, geocoder_completion_s *completion)
+{
+	__dispatch_task *task;
+
+	if(dispatch->mode == GEOCODER_DISPATCH_INLINE)
+	{
+		_geocoder_dispatch_run(dispatch, completion);
+		return;
+	}
+
+	task = g_new(__dispatch_task, 1);
+	task->dispatch = _geocoder_dispatch_ref(dispatch);
+	task->completion = completion;
+	if(dispatch->mode == GEOCODER_DISPATCH_THREAD_POOL)
+	{
+		g_thread_pool_push(dispatch->pool, task, NULL);
+	}
+	else
+	{
+		GSource *source = g_idle_source_new();
+		g_source_set_callback(source, __context_run, task, NULL);
+		g_source_attach(source, dispatch->context);
+		g_source_unref(source);
+	}
+}
+
+geocoder_dispatch_s* _geocoder_dispatch_new(geocoder_dispatch_mode_e mode, GMainContext *context)
+{
+	geocoder_dispatch_s *dispatch = g_new0(geocoder_dispatch_s, 1);
+	dispatch->ref = 1;
+	dispatch->mode = mode;
+	dispatch->gate = g_new0(__dispatch_gate, 1);
+	dispatch->gate->ref = 1;
+	g_rw_lock_init(&dispatch->gate->lock);
+
+	if(mode == GEOCODER_DISPATCH_CONTEXT)
+	{
+		dispatch->context = g_main_context_ref(context);
+	}
+	else if(mode == GEOCODER_DISPATCH_THREAD_POOL)
+	{
+		GError *error = NULL;
+		dispatch->pool = g_thread_pool_new(__pool_run, NULL, _GEOCODER_DISPATCH_THREADS, FALSE, &error);
+		if(dispatch->pool == NULL)
+		{
+			LOGE("[%s] GEOCODER_ERROR_SERVICE_NOT_AVAILABLE(0x%08x) : fail to create thread pool", __FUNCTION__, GEOCODER_ERROR_SERVICE_NOT_AVAILABLE);
+			g_error_free(error);
+			g_free(dispatch);
+			return NULL;
+		}
+	}
+	return dispatch;
+}
+
+geocoder_dispatch_s* _geocoder_dispatch_ref(geocoder_dispatch_s *dispatch)
+{
+	g_atomic_int_inc(&dispatch->ref);
+	return dispatch;
+}
+
+void _geocoder_dispatch_unref(geocoder_dispatch_s *dispatch)
+{
+	if(!g_atomic_int_dec_and_test(&dispatch->ref))
+		return;
+	if(dispatch->successor != NULL)
+	{
+		_geocoder_dispatch_add_overruns(dispatch->successor, g_atomic_int_get(&dispatch->overruns) - dispatch->overruns_at_release);
+		_geocoder_dispatch_unref(dispatch->successor);
+	}
+	if(dispatch->context != NULL)
+		g_main_context_unref(dispatch->context);
+	__gate_unref(dispatch->gate);
+	g_free(dispatch);
+}
+
+void _geocoder_dispatch_release(geocoder_dispatch_s *dispatch, geocoder_dispatch_s *successor)
+{
+	if(dispatch == NULL)
+		return;
+	if(successor != NULL)
+	{
+		/* Queued callbacks still run, the overruns counted until now already went over. The successor has nothing queued yet. */
+		dispatch->successor = _geocoder_dispatch_ref(successor);
+		dispatch->overruns_at_release = g_atomic_int_get(&dispatch->overruns);
+		g_atomic_int_inc(&dispatch->gate->ref);
+		__gate_unref(successor->gate);
+		successor->gate = dispatch->gate;
+	}
+	else if(g_private_get(&__running) == dispatch->gate)
+	{
+		/* Destroyed from one of its callbacks : in context mode, the only one running */
+		g_atomic_int_set(&dispatch->gate->released, 1);
+	}
+	else
+	{
+		/* Wait for the callbacks running on other threads */
+		g_rw_lock_writer_lock(&dispatch->gate->lock);
+		g_atomic_int_set(&dispatch->gate->released, 1);
+		g_rw_lock_writer_unlock(&dispatch->gate->lock);
+	}
+	/* The pool goes away after its queue is drained, without blocking a callback destroying the handle */
+	if(dispatch->pool != NULL)
+		g_thread_pool_free(dispatch->pool, FALSE, FALSE);
+	dispatch->pool = NULL;
+	_geocoder_dispatch_unref(dispatch);
+}
+
+void _geocoder_dispatch_set_budget(geocoder_dispatch_s *dispatch, int budget)
+{
+	g_atomic_int_set(&dispatch->budget, budget);
+}
+
+int _geocoder_dispatch_get_budget(geocoder_dispatch_s *dispatch)
+{
+	return g_atomic_int_get(&dispatch->budget);
+}
+
+int _geocoder_dispatch_get_overruns(geocoder_dispatch_s *dispatch)
+{
+	return g_atomic_int_get(&dispatch->overruns);
+}
+
+void _geocoder_dispatch_add_overruns(geocoder_dispatch_s *dispatch, int overruns)
+{
+	g_atomic_int_add(&dispatch->overruns, overruns);
+}
@@ -0,0 +1,177 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Interned strings
+*
+* Every distinct value is copied once into an arena and never freed, so interned pointers stay
+* valid for the life of the process and equal values compare equal by pointer. Each copy is
+* preceded by its hash. Only values from a bounded set are interned : those loaded from local
+* data files, and the states and country codes of provider responses. Their other fields would
+* grow the arena for as long as the process runs.
+*
+* The table is open addressed with linear probing. Readers load the table and its slots with
+* atomic reads and take no lock; writers insert under a lock, publishing a slot only after the
+* string is in place. A full table is replaced by a larger one, and the old one is kept alive
+* since readers may still be probing it; they miss what was inserted after the swap and retry
+* under the lock.
+*/
+
+#define _GEOCODER_INTERN_INITIAL_SIZE	1024
+#define _GEOCODER_INTERN_CHUNK_SIZE	(64 * 1024)
+#define _GEOCODER_INTERN_LARGE_SIZE	(_GEOCODER_INTERN_CHUNK_SIZE / 16)
+
+typedef struct __intern_table{
+	struct __intern_table *retired;	/* previous, smaller table */
+	guint mask;
+	guint used;
+	const gchar *slots[];
+}__intern_table;
+
+static __intern_table *__table = NULL;
+static gchar *__chunk = NULL;
+static gsize __chunk_used = 0;
+G_LOCK_DEFINE_STATIC(intern);
+
+static guint __hash(const gchar *str, gsize *length)
+{
+	/* FNV-1a */
+	guint hash = 2166136261u;
+	const guchar *p = (const guchar*)str;
+	for(; *p != '\0'; p++)
+	{
+		hash ^= *p;
+		hash *= 16777619u;
+	}
+	*length = p - (const guchar*)str;
+	return hash;
+}
+
+static guint __stored_hash(const gchar *interned)
+{
+	return ((const guint*)interned)[-1];
+}
+
+static const gchar* __find(__intern_table *table, const gchar *str, guint hash)
+{
+	guint i;
+
+	for(i = hash & table->mask; ; i = (i + 1) & table->mask)
+	{
+		const gchar *slot = g_atomic_pointer_get(&table->slots[i]);
+		if(slot == NULL)
+			return NULL;
+		if(__stored_hash(slot) == hash && strcmp(slot, str) == 0)
+			return slot;
+	}
+}
+
+static void __place(__intern_table *table, const gchar *interned)
+{
+	guint i;
+
+	for(i = __stored_hash(interned) & table->mask; table->slots[i] != NULL; i = (i + 1) & table->mask)
+		;
+	g_atomic_pointer_set(&table->slots[i], (gpointer)interned);
+	table->used++;
+}
+
+static __intern_table* __table_new(guint size)
+{
+	__intern_table *table = g_malloc0(sizeof(__intern_table) + size * sizeof(const gchar*));
+	table->mask = size - 1;
+	return table;
+}
+
+/* Called with the lock held */
+static const gchar* __copy(const gchar *str, gsize length, guint hash)
+{
+	gsize size = sizeof(guint) + length + 1;
+	gchar *block;
+
+	size = (size + sizeof(guint) - 1) & ~(sizeof(guint) - 1);
+	if(size > _GEOCODER_INTERN_LARGE_SIZE)
+	{
+		block = g_malloc(size);
+	}
+	else
+	{
+		if(__chunk == NULL || __chunk_used + size > _GEOCODER_INTERN_CHUNK_SIZE)
+		{
+			/* The tail of the previous chunk is abandoned */
+			__chunk = g_malloc(_GEOCODER_INTERN_CHUNK_SIZE);
+			__chunk_used = 0;
+		}
+		block = __chunk + __chunk_used;
+		__chunk_used += size;
+	}
+	*(guint*)block = hash;
+	memcpy(block + sizeof(guint), str, length + 1);
+	return block + sizeof(guint);
+}
+
+const gchar* _geocoder_intern(const gchar *str)
+{
+	__intern_table *table;
+	const gchar *interned;
+	gsize length;
+	guint hash;
+
+	if(str == NULL)
+		return NULL;
+
+	hash = __hash(str, &length);
+	table = g_atomic_pointer_get(&__table);
+	if(table != NULL && (interned = __find(table, str, hash)) != NULL)
+		return interned;
+
+	G_LOCK(intern);
+	if(__table == NULL)
+		g_atomic_pointer_set(&__table, __table_new(_GEOCODER_INTERN_INITIAL_SIZE));
+	table = __table;
+	interned = __find(table, str, hash);
+	if(interned == NULL)
+	{
+		if((table->used + 1) * 2 > table->mask + 1)
+		{
+			__intern_table *grown = __table_new((table->mask + 1) * 2);
+			guint i;
+			for(i = 0; i <= table->mask; i++)
+			{
+				if(table->slots[i] != NULL)
+					__place(grown, table->slots[i]);
+			}
+			grown->retired = table;
+			g_atomic_pointer_set(&__table, grown);
+			table = grown;
+		}
+		interned = __copy(str, length, hash);
+		__place(table, interned);
+	}
+	G_UNLOCK(intern);
+	return interned;
+}
@@ -0,0 +1,355 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Offline address data
+*
+* Addresses are kept in an implicit k-d tree over unit vectors on the sphere: the median of
+* each range along the split axis is the node, and the halves are its children. The chord
+* between two unit vectors grows with the great circle distance, so Euclidean pruning on the
+* tree gives exact nearest neighbours on the sphere.
+*/
+
+struct _geocoder_offline_s{
+	int count;
+	geocoder_offline_address_s *addresses;
+};
+
+void _geocoder_offline_unit_vector(double latitude, double longitude, double *xyz)
+{
+	double lat = latitude * M_PI / 180.0;
+	double lon = longitude * M_PI / 180.0;
+	xyz[0] = cos(lat) * cos(lon);
+	xyz[1] = cos(lat) * sin(lon);
+	xyz[2] = sin(lat);
+}
+
+double _geocoder_offline_meters(double chord2)
+{
+	double chord = sqrt(chord2);
+	return 2.0 * _GEOCODER_EARTH_RADIUS * asin(MIN(chord / 2.0, 1.0));
+}
+
+static double __meters_to_chord(double meters)
+{
+	if(meters >= M_PI * _GEOCODER_EARTH_RADIUS)
+		return 2.0;
+	return 2.0 * sin(meters / (2.0 * _GEOCODER_EARTH_RADIUS));
+}
+
+/*
+* Build
+*/
+static void __swap(geocoder_offline_address_s *a, geocoder_offline_address_s *b)
+{
+	geocoder_offline_address_s tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+/* Partially sorts [low, high) so that the nth element is in place along the axis */
+static void __select(geocoder_offline_address_s *addresses, int low, int high, int nth, int axis)
+{
+	while(high - low > 1)
+	{
+		double pivot = addresses[low + (high - low) / 2].xyz[axis];
+		int i = low;
+		int j = high - 1;
+		while(i <= j)
+		{
+			while(addresses[i].xyz[axis] < pivot)
+				i++;
+			while(addresses[j].xyz[axis] > pivot)
+				j--;
+			if(i <= j)
+				__swap(&addresses[i++], &addresses[j--]);
+		}
+		if(nth <= j)
+			high = j + 1;
+		else if(nth >= i)
+			low = i;
+		else
+			return;
+	}
+}
+
+static void __build(geocoder_offline_address_s *addresses, int low, int high, int depth)
+{
+	if(high - low <= 1)
+		return;
+	int mid = low + (high - low) / 2;
+	__select(addresses, low, high, mid, depth % 3);
+	__build(addresses, low, mid, depth + 1);
+	__build(addresses, mid + 1, high, depth + 1);
+}
+
+void _geocoder_offline_build(geocoder_offline_address_s *addresses, int count)
+{
+	__build(addresses, 0, count, 0);
+}
+
+static bool __parse_address(gchar *line, geocoder_offline_address_s *address)
+{
+	gchar **fields = g_strsplit(line, "\t", 9);
+	gchar *end = NULL;
+	bool ret = false;
+
+	if(g_strv_length(fields) == 9)
+	{
+		address->latitude = g_ascii_strtod(fields[0], &end);
+		if(end != fields[0] && address->latitude >= -90 && address->latitude <= 90)
+		{
+			address->longitude = g_ascii_strtod(fields[1], &end);
+			if(end != fields[1] && address->longitude >= -180 && address->longitude <= 180)
+			{
+				_geocoder_offline_unit_vector(address->latitude, address->longitude, address->xyz);
+				address->building_number = g_strdup(fields[2]);
+				address->postal_code = _geocoder_intern(fields[3]);
+				address->street = g_strdup(fields[4]);
+				address->city = _geocoder_intern(fields[5]);
+				address->district = _geocoder_intern(fields[6]);
+				address->state = _geocoder_intern(fields[7]);
+				address->country_code = _geocoder_intern(fields[8]);
+				ret = true;
+			}
+		}
+	}
+	g_strfreev(fields);
+	return ret;
+}
+
+int _geocoder_offline_load(const char *path, geocoder_offline_s **offline)
+{
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+	GArray *addresses;
+	gchar *line;
+	gchar *next;
+
+	if(!g_file_get_contents(path, &contents, &length, &error))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to read %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		g_error_free(error);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	addresses = g_array_new(FALSE, FALSE, sizeof(geocoder_offline_address_s));
+	for(line = contents; line != NULL && *line != '\0'; line = next)
+	{
+		geocoder_offline_address_s address;
+		next = strchr(line, '\n');
+		if(next != NULL)
+			*next++ = '\0';
+		g_strchomp(line);
+		if(line[0] == '#' || line[0] == '\0')
+			continue;
+		if(__parse_address(line, &address))
+			g_array_append_val(addresses, address);
+		else
+			LOGI("[%s] skip invalid line : %s", __FUNCTION__, line);
+	}
+	g_free(contents);
+
+	if(addresses->len == 0)
+	{
+		g_array_free(addresses, TRUE);
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : no address in %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	*offline = g_new0(geocoder_offline_s, 1);
+	(*offline)->count = addresses->len;
+	(*offline)->addresses = (geocoder_offline_address_s*)g_array_free(addresses, FALSE);
+	_geocoder_offline_build((*offline)->addresses, (*offline)->count);
+	LOGI("[%s] %d addresses", __FUNCTION__, (*offline)->count);
+	return GEOCODER_ERROR_NONE;
+}
+
+geocoder_offline_address_s* _geocoder_offline_addresses(geocoder_offline_s *offline, int *count)
+{
+	*count = offline->count;
+	return offline->addresses;
+}
+
+void _geocoder_offline_free(geocoder_offline_s *offline)
+{
+	int i;
+
+	if(offline == NULL)
+		return;
+	for(i = 0; i < offline->count; i++)
+	{
+		geocoder_offline_address_s *address = &offline->addresses[i];
+		g_free(address->building_number);
+		g_free(address->street);
+	}
+	g_free(offline->addresses);
+	g_free(offline);
+}
+
+/*
+* Search
+*/
+static void __heap_sift_down(geocoder_offline_neighbour_s *heap, int size, int i)
+{
+	while(true)
+	{
+		int largest = i;
+		int left = 2 * i + 1;
+		int right = left + 1;
+		if(left < size && heap[left].chord2 > heap[largest].chord2)
+			largest = left;
+		if(right < size && heap[right].chord2 > heap[largest].chord2)
+			largest = right;
+		if(largest == i)
+			return;
+		geocoder_offline_neighbour_s tmp = heap[i];
+		heap[i] = heap[largest];
+		heap[largest] = tmp;
+		i = largest;
+	}
+}
+
+static void __found(geocoder_offline_search_s *search, gconstpointer record, double chord2)
+{
+	geocoder_offline_neighbour_s neighbour = { record, chord2 };
+	geocoder_offline_neighbour_s *heap;
+	int i;
+
+	if(search->max_count == 0)
+	{
+		g_array_append_val(search->found, neighbour);
+		return;
+	}
+
+	heap = (geocoder_offline_neighbour_s*)search->found->data;
+	if((int)search->found->len == search->max_count)
+	{
+		/* Replace the farthest, and tighten the bound to the new farthest */
+		heap[0] = neighbour;
+		__heap_sift_down(heap, search->found->len, 0);
+		search->bound2 = heap[0].chord2;
+		return;
+	}
+
+	g_array_append_val(search->found, neighbour);
+	heap = (geocoder_offline_neighbour_s*)search->found->data;
+	for(i = search->found->len - 1; i > 0 && heap[(i - 1) / 2].chord2 < heap[i].chord2; i = (i - 1) / 2)
+	{
+		geocoder_offline_neighbour_s tmp = heap[i];
+		heap[i] = heap[(i - 1) / 2];
+		heap[(i - 1) / 2] = tmp;
+	}
+	if((int)search->found->len == search->max_count)
+		search->bound2 = MIN(search->bound2, heap[0].chord2);
+}
+
+static void __traverse(geocoder_offline_search_s *search, const guchar *records, gsize stride, int low, int high, int depth)
+{
+	while(low < high)
+	{
+		int mid = low + (high - low) / 2;
+		int axis = depth % 3;
+		const double *node = (const double*)(records + mid * stride);
+		double dx = node[0] - search->target[0];
+		double dy = node[1] - search->target[1];
+		double dz = node[2] - search->target[2];
+		double d2 = dx * dx + dy * dy + dz * dz;
+		double diff = search->target[axis] - node[axis];
+
+		if(d2 <= search->bound2)
+			__found(search, node, d2);
+
+		/* Near side first; the far side only if the splitting plane is within the bound */
+		if(diff < 0)
+		{
+			__traverse(search, records, stride, low, mid, depth + 1);
+			if(diff * diff > search->bound2)
+				return;
+			low = mid + 1;
+		}
+		else
+		{
+			__traverse(search, records, stride, mid + 1, high, depth + 1);
+			if(diff * diff > search->bound2)
+				return;
+			high = mid;
+		}
+		depth++;
+	}
+}
+
+static int __neighbour_compare(const void *a, const void *b)
+{
+	const geocoder_offline_neighbour_s *na = a;
+	const geocoder_offline_neighbour_s *nb = b;
+	return (na->chord2 > nb->chord2) - (na->chord2 < nb->chord2);
+}
+
+void _geocoder_offline_search_begin(geocoder_offline_search_s *search, double latitude, double longitude, int max_count, double radius)
+{
+	_geocoder_offline_unit_vector(latitude, longitude, search->target);
+	search->bound2 = radius > 0 ? pow(__meters_to_chord(radius), 2) : 4.0;
+	search->max_count = max_count;
+	search->found = g_array_sized_new(FALSE, FALSE, sizeof(geocoder_offline_neighbour_s), max_count > 0 ? max_count : 64);
+}
+
+/* Records start with their unit vector, and are laid out as _geocoder_offline_build() leaves them */
+void _geocoder_offline_search_run(geocoder_offline_search_s *search, gconstpointer records, int count, gsize stride)
+{
+	__traverse(search, records, stride, 0, count, 0);
+}
+
+/* Sorts the neighbours found, nearest first, and returns their number */
+int _geocoder_offline_search_end(geocoder_offline_search_s *search)
+{
+	qsort(search->found->data, search->found->len, sizeof(geocoder_offline_neighbour_s), __neighbour_compare);
+	return search->found->len;
+}
+
+int _geocoder_offline_nearest(geocoder_offline_s *offline, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data)
+{
+	geocoder_offline_search_s search;
+	int count;
+	int i;
+
+	_geocoder_offline_search_begin(&search, latitude, longitude, max_count, radius);
+	_geocoder_offline_search_run(&search, offline->addresses, offline->count, sizeof(geocoder_offline_address_s));
+	count = _geocoder_offline_search_end(&search);
+	for(i = 0; i < count; i++)
+	{
+		geocoder_offline_neighbour_s *neighbour = &g_array_index(search.found, geocoder_offline_neighbour_s, i);
+		const geocoder_offline_address_s *address = neighbour->record;
+		if(!callback(GEOCODER_ERROR_NONE, _geocoder_offline_meters(neighbour->chord2), address->latitude, address->longitude,
+				address->building_number, address->postal_code, address->street, address->city, address->district, address->state, address->country_code, user_data))
+			break;
+	}
+	g_array_free(search.found, TRUE);
+	return count;
+}
@@ -0,0 +1,163 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Freeform address parser
+*
+* Each country has one anchored pattern naming the components it captures. An address is parsed
+* when the whole string matches the pattern of exactly one country; anything looser, or matching
+* the patterns of several countries, is left to the provider's freeform search.
+*/
+
+#define _GEOCODER_PARSER_US_STATES \
+	"AL|AK|AZ|AR|CA|CO|CT|DE|DC|FL|GA|HI|ID|IL|IN|IA|KS|KY|LA|ME|MD|MA|MI|MN|MS|MO|MT|NE|NV|NH|NJ|NM|NY|NC|ND|OH|OK|OR|PA|RI|SC|SD|TN|TX|UT|VT|VA|WA|WV|WI|WY"
+
+typedef struct {
+	const char *country_code;
+	const char *pattern;
+}__parser_table;
+
+static const __parser_table __tables[] = {
+	/* 1600 Pennsylvania Ave NW, Washington, DC 20500 */
+	{ "US", "^(?<number>\\d+[a-z]?)\\s+(?<street>[^,]+?),\\s*(?<city>[^,]+?),\\s*(?<state>" _GEOCODER_PARSER_US_STATES ")\\s+(?<postal>\\d{5}(?:-\\d{4})?)(?:,\\s*(?:USA|US|United States))?$" },
+	/* 10 Downing Street, London SW1A 2AA */
+	{ "GB", "^(?<number>\\d+[a-z]?)\\s+(?<street>[^,]+?),\\s*(?<city>[^,]+?),?\\s+(?<postal>[a-z]{1,2}\\d[a-z\\d]?\\s*\\d[a-z]{2})(?:,\\s*(?:UK|United Kingdom|GB))?$" },
+	/* Unter den Linden 77, 10117 Berlin */
+	{ "DE", "^(?<street>[^,\\d][^,]*?)\\s+(?<number>\\d+\\s?[a-z]?),\\s*(?<postal>\\d{5})\\s+(?<city>[^,]+?)(?:,\\s*(?:Deutschland|Germany|DE))?$" },
+	/* 55 rue du Faubourg Saint-Honoré, 75008 Paris */
+	{ "FR", "^(?<number>\\d+(?:\\s?(?:bis|ter))?),?\\s+(?<street>[^,\\d][^,]*?[^,\\d\\s])\\s*,\\s*(?<postal>\\d{5})\\s+(?<city>[^,]+?)(?:,\\s*(?:France|FR))?$" },
+	/* 06236 서울특별시 강남구 테헤란로 152 */
+	{ "KR", "^(?:(?<postal>\\d{5})\\s+)?(?<state>\\S+(?:특별시|광역시|특별자치시|특별자치도|도))\\s+(?:(?<city>\\S+시)\\s+)?(?<district>\\S+[구군])\\s+(?<street>\\S+(?:로|길))\\s+(?<number>\\d+(?:-\\d+)?)$" },
+};
+
+#define _GEOCODER_PARSER_TABLE_NUM	(sizeof(__tables) / sizeof(__tables[0]))
+
+static GRegex *__compiled[_GEOCODER_PARSER_TABLE_NUM];
+
+static void __compile(void)
+{
+	static gsize compiled = 0;
+	guint i;
+
+	if(!g_once_init_enter(&compiled))
+		return;
+	for(i = 0; i < _GEOCODER_PARSER_TABLE_NUM; i++)
+	{
+		GError *error = NULL;
+		__compiled[i] = g_regex_new(__tables[i].pattern, G_REGEX_CASELESS | G_REGEX_OPTIMIZE, 0, &error);
+		if(__compiled[i] == NULL)
+		{
+			LOGE("[%s] fail to compile the %s pattern : %s", __FUNCTION__, __tables[i].country_code, error->message);
+			g_error_free(error);
+		}
+	}
+	g_once_init_leave(&compiled, 1);
+}
+
+/* Unmatched optional groups come back empty, groups the pattern lacks as NULL */
+static gchar* __fetch(GMatchInfo *match, const char *name)
+{
+	gchar *value = g_match_info_fetch_named(match, name);
+	gchar *from, *to;
+
+	if(value == NULL || *value == '\0')
+	{
+		g_free(value);
+		return NULL;
+	}
+	/* Runs of blanks become one space, trailing ones go */
+	for(from = to = value; *from != '\0'; from++)
+	{
+		if(!g_ascii_isspace(*from))
+			*to++ = *from;
+		else if(to > value && to[-1] != ' ')
+			*to++ = ' ';
+	}
+	if(to > value && to[-1] == ' ')
+		to--;
+	*to = '\0';
+	return value;
+}
+
+LocationAddress* _geocoder_parser_parse(const char *address)
+{
+	LocationAddress *parsed = NULL;
+	gchar *text;
+	guint i;
+
+	if(address == NULL)
+		return NULL;
+
+	__compile();
+	text = g_strstrip(g_strdup(address));
+	for(i = 0; i < _GEOCODER_PARSER_TABLE_NUM; i++)
+	{
+		GMatchInfo *match = NULL;
+		if(__compiled[i] == NULL)
+			continue;
+		if(g_regex_match(__compiled[i], text, 0, &match))
+		{
+			if(parsed != NULL)
+			{
+				LOGI("[%s] ambiguous between %s and %s", __FUNCTION__, parsed->country_code, __tables[i].country_code);
+				location_address_free(parsed);
+				g_match_info_free(match);
+				g_free(text);
+				return NULL;
+			}
+			gchar *number = __fetch(match, "number");
+			gchar *postal = __fetch(match, "postal");
+			gchar *street = __fetch(match, "street");
+			gchar *city = __fetch(match, "city");
+			gchar *district = __fetch(match, "district");
+			gchar *state = __fetch(match, "state");
+			parsed = location_address_new(number, street, district, city, state, __tables[i].country_code, postal);
+			g_free(number);
+			g_free(postal);
+			g_free(street);
+			g_free(city);
+			g_free(district);
+			g_free(state);
+		}
+		g_match_info_free(match);
+	}
+	g_free(text);
+	return parsed;
+}
+
+/* Addresses differing only in blanks, punctuation between components or a trailing country share a key */
+gchar* _geocoder_parser_key(const LocationAddress *parsed)
+{
+	return g_strdup_printf("%s\x1f%s\x1f%s\x1f%s\x1f%s\x1f%s\x1f%s",
+		parsed->country_code ? parsed->country_code : "",
+		parsed->state ? parsed->state : "",
+		parsed->city ? parsed->city : "",
+		parsed->district ? parsed->district : "",
+		parsed->postal_code ? parsed->postal_code : "",
+		parsed->street ? parsed->street : "",
+		parsed->building_number ? parsed->building_number : "");
+}
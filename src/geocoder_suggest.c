@@ -0,0 +1,396 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Gazetteer prefix index
+*
+* Keys (normalized, case folded names) are sorted and front coded in blocks of
+* _GEOCODER_GAZETTEER_BLOCK_SIZE: every entry stores the length of the prefix it shares with
+* the previous key and its own suffix. The first key of each block is also kept uncompressed
+* for the binary search, along with the highest weight in the block, so that blocks which
+* cannot improve the current top-K are skipped without being decoded.
+*/
+
+#define _GEOCODER_GAZETTEER_BLOCK_SIZE	16
+#define _GEOCODER_GAZETTEER_KEY_MAX	255
+
+struct _geocoder_gazetteer_s{
+	int count;
+	int block_count;
+	guint8 *keys;
+	guint32 *block_offsets;
+	gchar **block_heads;
+	float *block_max_weights;
+	gchar *names;
+	guint32 *name_offsets;
+	double *latitudes;
+	double *longitudes;
+	float *weights;
+};
+
+typedef struct {
+	gchar *key;
+	gchar *name;
+	double latitude;
+	double longitude;
+	float weight;
+}__gazetteer_entry;
+
+typedef struct {
+	int index;
+	float weight;
+}__suggestion;
+
+gchar* _geocoder_gazetteer_key(const char *text)
+{
+	gchar *normalized = g_utf8_normalize(text, -1, G_NORMALIZE_ALL);
+	if(normalized == NULL)
+		return NULL;
+	gchar *key = g_utf8_casefold(normalized, -1);
+	g_free(normalized);
+
+	gsize len = strlen(key);
+	if(len > _GEOCODER_GAZETTEER_KEY_MAX)
+	{
+		/* Cut on a character boundary */
+		gchar *end = key + _GEOCODER_GAZETTEER_KEY_MAX;
+		while(end > key && ((guint8)*end & 0xC0) == 0x80)
+			end--;
+		*end = '\0';
+	}
+	return key;
+}
+
+static int __entry_compare(const void *a, const void *b)
+{
+	const __gazetteer_entry *ea = a;
+	const __gazetteer_entry *eb = b;
+	int ret = strcmp(ea->key, eb->key);
+	if(ret != 0)
+		return ret;
+	return (ea->weight < eb->weight) - (ea->weight > eb->weight);
+}
+
+static bool __parse_entry(gchar *line, __gazetteer_entry *entry)
+{
+	gchar **fields = g_strsplit(line, "\t", 5);
+	guint n = g_strv_length(fields);
+	gchar *end = NULL;
+	bool ret = false;
+
+	if(n >= 3 && fields[0][0] != '\0')
+	{
+		entry->latitude = g_ascii_strtod(fields[1], &end);
+		if(end != fields[1] && entry->latitude >= -90 && entry->latitude <= 90)
+		{
+			entry->longitude = g_ascii_strtod(fields[2], &end);
+			if(end != fields[2] && entry->longitude >= -180 && entry->longitude <= 180)
+			{
+				entry->weight = n >= 4 ? g_ascii_strtod(fields[3], NULL) : 1.0;
+				entry->key = _geocoder_gazetteer_key(fields[0]);
+				entry->name = g_strdup(fields[0]);
+				ret = (entry->key != NULL);
+			}
+		}
+	}
+	g_strfreev(fields);
+	return ret;
+}
+
+static void __build(geocoder_gazetteer_s *gazetteer, __gazetteer_entry *entries, int count)
+{
+	GString *keys = g_string_sized_new(count * 8);
+	GString *names = g_string_sized_new(count * 16);
+	const gchar *prev = "";
+	int i;
+
+	gazetteer->count = count;
+	gazetteer->block_count = (count + _GEOCODER_GAZETTEER_BLOCK_SIZE - 1) / _GEOCODER_GAZETTEER_BLOCK_SIZE;
+	gazetteer->block_offsets = g_new(guint32, gazetteer->block_count);
+	gazetteer->block_heads = g_new(gchar*, gazetteer->block_count);
+	gazetteer->block_max_weights = g_new(float, gazetteer->block_count);
+	gazetteer->name_offsets = g_new(guint32, count);
+	gazetteer->latitudes = g_new(double, count);
+	gazetteer->longitudes = g_new(double, count);
+	gazetteer->weights = g_new(float, count);
+
+	for(i = 0; i < count; i++)
+	{
+		int block = i / _GEOCODER_GAZETTEER_BLOCK_SIZE;
+		int shared = 0;
+		int suffix;
+
+		if(i % _GEOCODER_GAZETTEER_BLOCK_SIZE == 0)
+		{
+			gazetteer->block_offsets[block] = keys->len;
+			gazetteer->block_heads[block] = g_strdup(entries[i].key);
+			gazetteer->block_max_weights[block] = entries[i].weight;
+		}
+		else
+		{
+			while(prev[shared] != '\0' && prev[shared] == entries[i].key[shared])
+				shared++;
+			gazetteer->block_max_weights[block] = MAX(gazetteer->block_max_weights[block], entries[i].weight);
+		}
+		suffix = strlen(entries[i].key) - shared;
+		g_string_append_c(keys, (gchar)shared);
+		g_string_append_c(keys, (gchar)suffix);
+		g_string_append_len(keys, entries[i].key + shared, suffix);
+		prev = entries[i].key;
+
+		gazetteer->name_offsets[i] = names->len;
+		g_string_append_len(names, entries[i].name, strlen(entries[i].name) + 1);
+		gazetteer->latitudes[i] = entries[i].latitude;
+		gazetteer->longitudes[i] = entries[i].longitude;
+		gazetteer->weights[i] = entries[i].weight;
+	}
+
+	gazetteer->keys = (guint8*)g_string_free(keys, FALSE);
+	gazetteer->names = g_string_free(names, FALSE);
+}
+
+int _geocoder_gazetteer_load(const char *path, geocoder_gazetteer_s **gazetteer)
+{
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+	GArray *entries;
+	gchar *line;
+	gchar *next;
+	int i;
+
+	if(!g_file_get_contents(path, &contents, &length, &error))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to read %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		g_error_free(error);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	entries = g_array_new(FALSE, FALSE, sizeof(__gazetteer_entry));
+	for(line = contents; line != NULL && *line != '\0'; line = next)
+	{
+		__gazetteer_entry entry;
+		next = strchr(line, '\n');
+		if(next != NULL)
+			*next++ = '\0';
+		g_strchomp(line);
+		if(line[0] == '#' || line[0] == '\0')
+			continue;
+		if(__parse_entry(line, &entry))
+			g_array_append_val(entries, entry);
+		else
+			LOGI("[%s] skip invalid line : %s", __FUNCTION__, line);
+	}
+	g_free(contents);
+
+	if(entries->len == 0)
+	{
+		g_array_free(entries, TRUE);
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : no entry in %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	qsort(entries->data, entries->len, sizeof(__gazetteer_entry), __entry_compare);
+
+	*gazetteer = g_new0(geocoder_gazetteer_s, 1);
+	__build(*gazetteer, (__gazetteer_entry*)entries->data, entries->len);
+
+	for(i = 0; i < (int)entries->len; i++)
+	{
+		g_free(g_array_index(entries, __gazetteer_entry, i).key);
+		g_free(g_array_index(entries, __gazetteer_entry, i).name);
+	}
+	LOGI("[%s] %d entries, %d blocks", __FUNCTION__, (*gazetteer)->count, (*gazetteer)->block_count);
+	g_array_free(entries, TRUE);
+	return GEOCODER_ERROR_NONE;
+}
+
+void _geocoder_gazetteer_free(geocoder_gazetteer_s *gazetteer)
+{
+	int i;
+
+	if(gazetteer == NULL)
+		return;
+	for(i = 0; i < gazetteer->block_count; i++)
+		g_free(gazetteer->block_heads[i]);
+	g_free(gazetteer->block_heads);
+	g_free(gazetteer->block_offsets);
+	g_free(gazetteer->block_max_weights);
+	g_free(gazetteer->keys);
+	g_free(gazetteer->names);
+	g_free(gazetteer->name_offsets);
+	g_free(gazetteer->latitudes);
+	g_free(gazetteer->longitudes);
+	g_free(gazetteer->weights);
+	g_free(gazetteer);
+}
+
+/*
+* Lookup
+*/
+static void __heap_sift_down(__suggestion *heap, int size, int i)
+{
+	while(true)
+	{
+		int smallest = i;
+		int left = 2 * i + 1;
+		int right = left + 1;
+		if(left < size && heap[left].weight < heap[smallest].weight)
+			smallest = left;
+		if(right < size && heap[right].weight < heap[smallest].weight)
+			smallest = right;
+		if(smallest == i)
+			return;
+		__suggestion tmp = heap[i];
+		heap[i] = heap[smallest];
+		heap[smallest] = tmp;
+		i = smallest;
+	}
+}
+
+static void __heap_push(__suggestion *heap, int *size, int capacity, int index, float weight)
+{
+	int i;
+
+	if(*size == capacity)
+	{
+		if(weight <= heap[0].weight)
+			return;
+		heap[0].index = index;
+		heap[0].weight = weight;
+		__heap_sift_down(heap, *size, 0);
+		return;
+	}
+
+	i = (*size)++;
+	heap[i].index = index;
+	heap[i].weight = weight;
+	while(i > 0 && heap[(i - 1) / 2].weight > heap[i].weight)
+	{
+		__suggestion tmp = heap[i];
+		heap[i] = heap[(i - 1) / 2];
+		heap[(i - 1) / 2] = tmp;
+		i = (i - 1) / 2;
+	}
+}
+
+static bool __has_prefix(const char *key, const char *prefix, gsize prefix_len)
+{
+	return strncmp(key, prefix, prefix_len) == 0;
+}
+
+/* Index of the last block whose head is < prefix, so that a run of equal keys is entered at its first block */
+static int __find_block(geocoder_gazetteer_s *gazetteer, const char *prefix)
+{
+	int low = 0;
+	int high = gazetteer->block_count - 1;
+
+	while(low < high)
+	{
+		int mid = (low + high + 1) / 2;
+		if(strcmp(gazetteer->block_heads[mid], prefix) < 0)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	return low;
+}
+
+int _geocoder_gazetteer_lookup(geocoder_gazetteer_s *gazetteer, const char *prefix, int max_count, geocoder_suggestion_cb callback, void *user_data)
+{
+	gchar *key = _geocoder_gazetteer_key(prefix);
+	gsize key_len;
+	__suggestion *heap;
+	int size = 0;
+	int block;
+	int i;
+
+	if(key == NULL)
+		return 0;
+	key_len = strlen(key);
+	heap = g_new(__suggestion, max_count);
+
+	for(block = __find_block(gazetteer, key); block < gazetteer->block_count; block++)
+	{
+		bool head_in_range = __has_prefix(gazetteer->block_heads[block], key, key_len);
+		bool next_in_range = (block + 1 < gazetteer->block_count && __has_prefix(gazetteer->block_heads[block + 1], key, key_len));
+
+		/* Past the range : the previous block was the last one */
+		if(!head_in_range && strcmp(gazetteer->block_heads[block], key) > 0)
+			break;
+
+		/* The whole block matches, decode it only if it can beat the current top-K */
+		if(head_in_range && next_in_range && size == max_count && gazetteer->block_max_weights[block] <= heap[0].weight)
+			continue;
+
+		gchar current[_GEOCODER_GAZETTEER_KEY_MAX + 1];
+		const guint8 *p = gazetteer->keys + gazetteer->block_offsets[block];
+		int first = block * _GEOCODER_GAZETTEER_BLOCK_SIZE;
+		int last = MIN(first + _GEOCODER_GAZETTEER_BLOCK_SIZE, gazetteer->count);
+		bool matched = false;
+
+		for(i = first; i < last; i++)
+		{
+			int shared = p[0];
+			int suffix = p[1];
+			memcpy(current + shared, p + 2, suffix);
+			current[shared + suffix] = '\0';
+			p += 2 + suffix;
+
+			if(__has_prefix(current, key, key_len))
+			{
+				matched = true;
+				__heap_push(heap, &size, max_count, i, gazetteer->weights[i]);
+			}
+			else if(matched || strcmp(current, key) > 0)
+			{
+				break;
+			}
+		}
+		if(!next_in_range && (matched || head_in_range))
+			break;
+	}
+	g_free(key);
+
+	/* Heap order to descending weight */
+	int count = size;
+	while(size > 1)
+	{
+		__suggestion tmp = heap[0];
+		heap[0] = heap[--size];
+		heap[size] = tmp;
+		__heap_sift_down(heap, size, 0);
+	}
+	for(i = 0; i < count; i++)
+	{
+		int index = heap[i].index;
+		if(!callback(GEOCODER_ERROR_NONE, gazetteer->names + gazetteer->name_offsets[index], gazetteer->latitudes[index], gazetteer->longitudes[index], user_data))
+			break;
+	}
+	g_free(heap);
+	return count;
+}
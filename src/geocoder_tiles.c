@@ -0,0 +1,616 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Offline data tiles
+*
+* The offline addresses are split by geohash cell, one file per cell named after its geohash.
+* A tile holds its addresses already laid out as a k-d tree, followed by a pool of strings the
+* records point into, so it is searched in place once mapped, without any parsing.
+*
+* Tiles are mapped on first use and kept in LRU order; after each search the coldest ones are
+* unmapped until the mapped size fits the budget. Cells without a file are remembered as empty.
+* Searches only visit the cells within their radius, nearest first, and stop at the first cell
+* that cannot hold anything nearer than what was already found.
+*/
+
+#define _GEOCODER_TILE_MAGIC		"GEOP"
+#define _GEOCODER_TILE_VERSION		1
+#define _GEOCODER_TILE_PRECISION	4		/* geohash characters */
+#define _GEOCODER_TILE_BITS		10		/* per axis, at that precision */
+#define _GEOCODER_TILE_CELLS		(1 << _GEOCODER_TILE_BITS)
+#define _GEOCODER_TILE_SUFFIX		".tile"
+#define _GEOCODER_TILE_MAX_RADIUS	100000.0	/* meters */
+#define _GEOCODER_TILE_MAX_ENTRIES	4096		/* tiles remembered, mapped or empty */
+
+typedef enum {
+	_TILE_BUILDING_NUMBER,
+	_TILE_POSTAL_CODE,
+	_TILE_STREET,
+	_TILE_CITY,
+	_TILE_DISTRICT,
+	_TILE_STATE,
+	_TILE_COUNTRY_CODE,
+	_TILE_FIELD_NUM
+}__tile_field_e;
+
+typedef struct {
+	char magic[4];
+	guint32 version;
+	guint32 count;
+	guint32 pool_size;
+}__tile_header;
+
+/* Starts with the unit vector, as _geocoder_offline_search_run() expects */
+typedef struct {
+	double xyz[3];
+	double latitude;
+	double longitude;
+	guint32 fields[_TILE_FIELD_NUM];	/* offsets in the string pool */
+	guint32 reserved;
+}__tile_record;
+
+typedef struct {
+	gchar name[_GEOCODER_TILE_PRECISION + 1];
+	gpointer map;		/* NULL : no tile for the cell */
+	gsize size;
+	const __tile_record *records;
+	guint32 count;
+	const gchar *pool;
+	guint32 pool_size;
+	GList link;		/* in the LRU queue */
+}__tile;
+
+struct _geocoder_tiles_s{
+	gchar *directory;
+	gsize budget;
+	gsize mapped;
+	GHashTable *tiles;	/* name -> __tile */
+	GQueue lru;		/* most recently used first */
+};
+
+typedef struct {
+	int x;
+	int y;
+	double reach;		/* no point of the cell is nearer to the target, as a chord */
+}__cell;
+
+static const char __base32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+/*
+* Cells
+*/
+static int __cell_x(double longitude)
+{
+	int x = (int)floor((longitude + 180.0) / 360.0 * _GEOCODER_TILE_CELLS);
+	return CLAMP(x, 0, _GEOCODER_TILE_CELLS - 1);
+}
+
+static int __cell_y(double latitude)
+{
+	int y = (int)floor((latitude + 90.0) / 180.0 * _GEOCODER_TILE_CELLS);
+	return CLAMP(y, 0, _GEOCODER_TILE_CELLS - 1);
+}
+
+static void __cell_name(int x, int y, gchar *name)
+{
+	guint32 bits = 0;
+	int i;
+
+	/* Longitude takes the first bit, then the axes alternate */
+	for(i = _GEOCODER_TILE_BITS - 1; i >= 0; i--)
+		bits = (bits << 2) | (((x >> i) & 1) << 1) | ((y >> i) & 1);
+	for(i = 0; i < _GEOCODER_TILE_PRECISION; i++)
+		name[i] = __base32[(bits >> (5 * (_GEOCODER_TILE_PRECISION - 1 - i))) & 0x1f];
+	name[_GEOCODER_TILE_PRECISION] = '\0';
+}
+
+static bool __is_cell_name(const char *name)
+{
+	int i;
+
+	for(i = 0; i < _GEOCODER_TILE_PRECISION; i++)
+	{
+		if(name[i] == '\0' || strchr(__base32, name[i]) == NULL)
+			return false;
+	}
+	return name[i] == '\0';
+}
+
+static double __chord2(const double *a, const double *b)
+{
+	double dx = a[0] - b[0];
+	double dy = a[1] - b[1];
+	double dz = a[2] - b[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+/* Distance from the target to the centre, less the farthest the cell's boundary gets from the centre */
+static double __cell_reach(const double *target, int x, int y)
+{
+	double width = 360.0 / _GEOCODER_TILE_CELLS;
+	double height = 180.0 / _GEOCODER_TILE_CELLS;
+	double west = x * width - 180.0;
+	double south = y * height - 90.0;
+	double centre[3];
+	double spread = 0;
+	int i, j;
+
+	_geocoder_offline_unit_vector(south + height / 2, west + width / 2, centre);
+	for(i = 0; i <= 2; i++)
+	{
+		for(j = 0; j <= 2; j++)
+		{
+			double point[3];
+			_geocoder_offline_unit_vector(south + i * height / 2, west + j * width / 2, point);
+			spread = MAX(spread, __chord2(centre, point));
+		}
+	}
+	return MAX(sqrt(__chord2(target, centre)) - sqrt(spread) * 1.01, 0);
+}
+
+static int __cell_compare(const void *a, const void *b)
+{
+	const __cell *ca = a;
+	const __cell *cb = b;
+	return (ca->reach > cb->reach) - (ca->reach < cb->reach);
+}
+
+/* Cells that may hold points within the radius, nearest first */
+static GArray* __cells_within(const double *target, double latitude, double longitude, double radius)
+{
+	GArray *cells = g_array_new(FALSE, FALSE, sizeof(__cell));
+	double angle = radius / _GEOCODER_EARTH_RADIUS;
+	double spread = angle * 180.0 / M_PI;
+	int y0 = __cell_y(latitude - spread);
+	int y1 = __cell_y(latitude + spread);
+	int x0 = 0;
+	int x1 = _GEOCODER_TILE_CELLS - 1;
+	int x, y;
+
+	if(sin(angle) < cos(latitude * M_PI / 180.0))
+	{
+		double reach = asin(sin(angle) / cos(latitude * M_PI / 180.0)) * 180.0 / M_PI;
+		x0 = (int)floor((longitude - reach + 180.0) / 360.0 * _GEOCODER_TILE_CELLS);
+		x1 = (int)floor((longitude + reach + 180.0) / 360.0 * _GEOCODER_TILE_CELLS);
+		if(x1 - x0 >= _GEOCODER_TILE_CELLS)
+		{
+			x0 = 0;
+			x1 = _GEOCODER_TILE_CELLS - 1;
+		}
+	}
+
+	for(y = y0; y <= y1; y++)
+	{
+		for(x = x0; x <= x1; x++)
+		{
+			__cell cell;
+			cell.x = (x % _GEOCODER_TILE_CELLS + _GEOCODER_TILE_CELLS) % _GEOCODER_TILE_CELLS;
+			cell.y = y;
+			cell.reach = __cell_reach(target, cell.x, cell.y);
+			g_array_append_val(cells, cell);
+		}
+	}
+	qsort(cells->data, cells->len, sizeof(__cell), __cell_compare);
+	return cells;
+}
+
+/*
+* Tile files
+*/
+static gchar* __tile_path(geocoder_tiles_s *tiles, const gchar *name)
+{
+	gchar *file = g_strconcat(name, _GEOCODER_TILE_SUFFIX, NULL);
+	gchar *path = g_build_filename(tiles->directory, file, NULL);
+	g_free(file);
+	return path;
+}
+
+/* Returns an empty tile when the file is missing or invalid */
+static __tile* __tile_map(const char *path, const gchar *name)
+{
+	__tile *tile = g_new0(__tile, 1);
+	const __tile_header *header;
+	struct stat st;
+	gsize body_size;
+	gsize records_size;
+	int fd;
+
+	g_strlcpy(tile->name, name, sizeof(tile->name));
+	tile->link.data = tile;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return tile;
+	if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(__tile_header) || (guint64)st.st_size > G_MAXSIZE)
+	{
+		LOGE("[%s] %s : too short or too large", __FUNCTION__, path);
+		close(fd);
+		return tile;
+	}
+	tile->map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(tile->map == MAP_FAILED)
+	{
+		LOGE("[%s] %s : fail to map", __FUNCTION__, path);
+		tile->map = NULL;
+		return tile;
+	}
+	tile->size = st.st_size;
+
+	header = tile->map;
+	/* Each term is checked against what is left of the file, so that no sum can wrap on 32-bit */
+	body_size = tile->size - sizeof(__tile_header);
+	records_size = header->count <= body_size / sizeof(__tile_record) ? (gsize)header->count * sizeof(__tile_record) : body_size + 1;
+	if(memcmp(header->magic, _GEOCODER_TILE_MAGIC, 4) != 0 || header->version != _GEOCODER_TILE_VERSION
+		|| records_size > body_size || header->pool_size == 0 || header->pool_size != body_size - records_size
+		|| ((const gchar*)tile->map)[tile->size - 1] != '\0')
+	{
+		LOGE("[%s] %s : not a version %d tile", __FUNCTION__, path, _GEOCODER_TILE_VERSION);
+		munmap(tile->map, tile->size);
+		tile->map = NULL;
+		tile->size = 0;
+		return tile;
+	}
+	/* The k-d tree is walked, not scanned */
+	madvise(tile->map, tile->size, MADV_RANDOM);
+	tile->records = (const __tile_record*)((const guchar*)tile->map + sizeof(__tile_header));
+	tile->count = header->count;
+	tile->pool = (const gchar*)tile->records + records_size;
+	tile->pool_size = header->pool_size;
+	return tile;
+}
+
+static void __tile_unmap(__tile *tile)
+{
+	if(tile->map != NULL)
+		munmap(tile->map, tile->size);
+	g_free(tile);
+}
+
+static const gchar* __tile_field(const __tile *tile, const __tile_record *record, __tile_field_e field)
+{
+	guint32 offset = record->fields[field];
+	return offset < tile->pool_size ? tile->pool + offset : "";
+}
+
+/*
+* Residency
+*/
+static void __tile_insert(geocoder_tiles_s *tiles, __tile *tile)
+{
+	g_hash_table_insert(tiles->tiles, tile->name, tile);
+	g_queue_push_head_link(&tiles->lru, &tile->link);
+	tiles->mapped += tile->size;
+}
+
+static void __tile_drop(geocoder_tiles_s *tiles, __tile *tile)
+{
+	g_hash_table_remove(tiles->tiles, tile->name);
+	g_queue_unlink(&tiles->lru, &tile->link);
+	tiles->mapped -= tile->size;
+	__tile_unmap(tile);
+}
+
+static __tile* __tile_get(geocoder_tiles_s *tiles, int x, int y)
+{
+	gchar name[_GEOCODER_TILE_PRECISION + 1];
+	__tile *tile;
+
+	__cell_name(x, y, name);
+	tile = g_hash_table_lookup(tiles->tiles, name);
+	if(tile != NULL)
+	{
+		g_queue_unlink(&tiles->lru, &tile->link);
+		g_queue_push_head_link(&tiles->lru, &tile->link);
+		return tile;
+	}
+
+	gchar *path = __tile_path(tiles, name);
+	tile = __tile_map(path, name);
+	g_free(path);
+	__tile_insert(tiles, tile);
+	return tile;
+}
+
+static void __evict(geocoder_tiles_s *tiles)
+{
+	while(tiles->lru.tail != NULL && (tiles->mapped > tiles->budget || tiles->lru.length > _GEOCODER_TILE_MAX_ENTRIES))
+		__tile_drop(tiles, tiles->lru.tail->data);
+}
+
+/*
+* Open, close
+*/
+int _geocoder_tiles_open(const char *directory, gsize budget, geocoder_tiles_s **tiles)
+{
+	if(!g_file_test(directory, G_FILE_TEST_IS_DIR))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : %s is not a directory", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, directory);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	*tiles = g_new0(geocoder_tiles_s, 1);
+	(*tiles)->directory = g_strdup(directory);
+	(*tiles)->budget = budget;
+	(*tiles)->tiles = g_hash_table_new(g_str_hash, g_str_equal);
+	g_queue_init(&(*tiles)->lru);
+	return GEOCODER_ERROR_NONE;
+}
+
+void _geocoder_tiles_close(geocoder_tiles_s *tiles)
+{
+	if(tiles == NULL)
+		return;
+	while(tiles->lru.head != NULL)
+		__tile_drop(tiles, tiles->lru.head->data);
+	g_hash_table_destroy(tiles->tiles);
+	g_free(tiles->directory);
+	g_free(tiles);
+}
+
+void _geocoder_tiles_set_budget(geocoder_tiles_s *tiles, gsize budget)
+{
+	tiles->budget = budget;
+	__evict(tiles);
+}
+
+/*
+* Search
+*/
+int _geocoder_tiles_nearest(geocoder_tiles_s *tiles, double latitude, double longitude, int max_count, double radius, geocoder_nearby_address_cb callback, void *user_data)
+{
+	geocoder_offline_search_s search;
+	GArray *cells;
+	GPtrArray *searched;	/* tiles the records found point into */
+	guint c;
+	int count;
+	int i;
+
+	if(radius <= 0 || radius > _GEOCODER_TILE_MAX_RADIUS)
+		radius = _GEOCODER_TILE_MAX_RADIUS;
+
+	_geocoder_offline_search_begin(&search, latitude, longitude, max_count, radius);
+	cells = __cells_within(search.target, latitude, longitude, radius);
+	searched = g_ptr_array_new();
+	for(c = 0; c < cells->len; c++)
+	{
+		__cell *cell = &g_array_index(cells, __cell, c);
+		__tile *tile;
+		if(cell->reach * cell->reach > search.bound2)
+			break;
+		tile = __tile_get(tiles, cell->x, cell->y);
+		if(tile->map != NULL)
+		{
+			_geocoder_offline_search_run(&search, tile->records, tile->count, sizeof(__tile_record));
+			g_ptr_array_add(searched, tile);
+		}
+	}
+	g_array_free(cells, TRUE);
+
+	/* Tiles stay mapped until the callbacks are done with their strings */
+	count = _geocoder_offline_search_end(&search);
+	for(i = 0; i < count; i++)
+	{
+		geocoder_offline_neighbour_s *neighbour = &g_array_index(search.found, geocoder_offline_neighbour_s, i);
+		const __tile_record *record = neighbour->record;
+		const __tile *tile = NULL;
+		guint t;
+
+		for(t = 0; tile == NULL && t < searched->len; t++)
+		{
+			const __tile *candidate = g_ptr_array_index(searched, t);
+			if(record >= candidate->records && record < candidate->records + candidate->count)
+				tile = candidate;
+		}
+		if(!callback(GEOCODER_ERROR_NONE, _geocoder_offline_meters(neighbour->chord2), record->latitude, record->longitude,
+				__tile_field(tile, record, _TILE_BUILDING_NUMBER), __tile_field(tile, record, _TILE_POSTAL_CODE), __tile_field(tile, record, _TILE_STREET),
+				__tile_field(tile, record, _TILE_CITY), __tile_field(tile, record, _TILE_DISTRICT), __tile_field(tile, record, _TILE_STATE),
+				__tile_field(tile, record, _TILE_COUNTRY_CODE), user_data))
+			break;
+	}
+	g_ptr_array_free(searched, TRUE);
+	g_array_free(search.found, TRUE);
+	__evict(tiles);
+	return count;
+}
+
+/*
+* Update
+*/
+int _geocoder_tiles_update(geocoder_tiles_s *tiles, const char *tile_name, const char *path)
+{
+	__tile *fresh;
+	__tile *stale;
+	gchar *target;
+
+	if(!__is_cell_name(tile_name))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : %s is not a geohash of %d characters", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, tile_name, _GEOCODER_TILE_PRECISION);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+	fresh = __tile_map(path, tile_name);
+	if(fresh->map == NULL)
+	{
+		__tile_unmap(fresh);
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : %s is not a tile", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The mapping follows the file, so the new tile is used as mapped here */
+	target = __tile_path(tiles, tile_name);
+	if(rename(path, target) != 0)
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to move %s to %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path, target);
+		g_free(target);
+		__tile_unmap(fresh);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+	g_free(target);
+
+	stale = g_hash_table_lookup(tiles->tiles, tile_name);
+	if(stale != NULL)
+		__tile_drop(tiles, stale);
+	__tile_insert(tiles, fresh);
+	__evict(tiles);
+	return GEOCODER_ERROR_NONE;
+}
+
+/*
+* Export
+*/
+static guint32 __pool_add(GString *pool, GHashTable *offsets, const gchar *value)
+{
+	gpointer offset;
+
+	if(value == NULL || *value == '\0')
+		return 0;
+	if(g_hash_table_lookup_extended(offsets, value, NULL, &offset))
+		return GPOINTER_TO_UINT(offset);
+	offset = GUINT_TO_POINTER(pool->len);
+	g_string_append_len(pool, value, strlen(value) + 1);
+	g_hash_table_insert(offsets, (gpointer)value, offset);
+	return GPOINTER_TO_UINT(offset);
+}
+
+static int __tile_write(const char *directory, const gchar *name, GArray *addresses)
+{
+	__tile_header header;
+	__tile_record *records = g_new0(__tile_record, addresses->len);
+	GString *pool = g_string_new_len("", 1);	/* offset 0 is the empty string */
+	GHashTable *offsets = g_hash_table_new(g_str_hash, g_str_equal);
+	gchar *file = g_strconcat(name, _GEOCODER_TILE_SUFFIX, NULL);
+	gchar *path = g_build_filename(directory, file, NULL);
+	gchar *temp = g_strconcat(path, ".tmp", NULL);
+	int ret = GEOCODER_ERROR_NONE;
+	bool written = false;
+	FILE *out;
+	guint i;
+
+	_geocoder_offline_build((geocoder_offline_address_s*)addresses->data, addresses->len);
+	for(i = 0; i < addresses->len; i++)
+	{
+		const geocoder_offline_address_s *address = &g_array_index(addresses, geocoder_offline_address_s, i);
+		__tile_record *record = &records[i];
+		memcpy(record->xyz, address->xyz, sizeof(record->xyz));
+		record->latitude = address->latitude;
+		record->longitude = address->longitude;
+		record->fields[_TILE_BUILDING_NUMBER] = __pool_add(pool, offsets, address->building_number);
+		record->fields[_TILE_POSTAL_CODE] = __pool_add(pool, offsets, address->postal_code);
+		record->fields[_TILE_STREET] = __pool_add(pool, offsets, address->street);
+		record->fields[_TILE_CITY] = __pool_add(pool, offsets, address->city);
+		record->fields[_TILE_DISTRICT] = __pool_add(pool, offsets, address->district);
+		record->fields[_TILE_STATE] = __pool_add(pool, offsets, address->state);
+		record->fields[_TILE_COUNTRY_CODE] = __pool_add(pool, offsets, address->country_code);
+	}
+
+	memcpy(header.magic, _GEOCODER_TILE_MAGIC, 4);
+	header.version = _GEOCODER_TILE_VERSION;
+	header.count = addresses->len;
+	header.pool_size = pool->len;
+
+	/* Written aside and moved in place, so a tile mapped elsewhere never changes under its reader */
+	out = fopen(temp, "wb");
+	if(out != NULL)
+	{
+		written = fwrite(&header, sizeof(header), 1, out) == 1
+			&& fwrite(records, sizeof(__tile_record), addresses->len, out) == addresses->len
+			&& fwrite(pool->str, 1, pool->len, out) == pool->len;
+		/* Closed whatever happened, its flush may fail too */
+		if(fclose(out) != 0)
+			written = false;
+		if(!written || rename(temp, path) != 0)
+		{
+			unlink(temp);
+			written = false;
+		}
+	}
+	if(!written)
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to write %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		ret = GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	g_free(temp);
+	g_free(path);
+	g_free(file);
+	g_hash_table_destroy(offsets);
+	g_string_free(pool, TRUE);
+	g_free(records);
+	return ret;
+}
+
+static void __free_addresses(gpointer addresses)
+{
+	g_array_free(addresses, TRUE);
+}
+
+int _geocoder_tiles_export(geocoder_offline_s *offline, const char *directory)
+{
+	GHashTable *cells;
+	GHashTableIter iter;
+	gpointer name, addresses;
+	geocoder_offline_address_s *all;
+	int count;
+	int ret = GEOCODER_ERROR_NONE;
+	int i;
+
+	if(g_mkdir_with_parents(directory, 0755) != 0)
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to create %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, directory);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The copies share their strings with the offline data */
+	cells = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, __free_addresses);
+	all = _geocoder_offline_addresses(offline, &count);
+	for(i = 0; i < count; i++)
+	{
+		gchar cell[_GEOCODER_TILE_PRECISION + 1];
+		GArray *list;
+		__cell_name(__cell_x(all[i].longitude), __cell_y(all[i].latitude), cell);
+		list = g_hash_table_lookup(cells, cell);
+		if(list == NULL)
+		{
+			list = g_array_new(FALSE, FALSE, sizeof(geocoder_offline_address_s));
+			g_hash_table_insert(cells, g_strdup(cell), list);
+		}
+		g_array_append_val(list, all[i]);
+	}
+
+	g_hash_table_iter_init(&iter, cells);
+	while(ret == GEOCODER_ERROR_NONE && g_hash_table_iter_next(&iter, &name, &addresses))
+		ret = __tile_write(directory, name, addresses);
+	LOGI("[%s] %d addresses in %d tiles", __FUNCTION__, count, g_hash_table_size(cells));
+	g_hash_table_destroy(cells);
+	return ret;
+}
@@ -0,0 +1,568 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <geocoder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_GEOCODER"
+
+/*
+* Backend traces
+*
+* A trace is a header followed by one record per backend request, written when the response
+* arrives, in native byte order :
+*
+*	header	: "GEOT", u32 version
+*	record	: u8 kind, i32 error, u32 latency (ms), request, response
+*	request	: address kind : f64 latitude, f64 longitude; position kind : string address
+*	response	: address kind : 7 strings (building number, postal code, street, city, district, state, country code), accuracy
+*		  position kind : u16 count, count positions, u16 count, count accuracies
+*	position	: u32 timestamp, f64 latitude, f64 longitude, f64 altitude, u8 status
+*	accuracy	: u8 level (0xff : none), f64 horizontal, f64 vertical
+*	string	: u16 length (0xffff : NULL), bytes
+*
+* Replay matches requests to records by their key, serving the records of a key in order and
+* repeating the last one when they run out, so a replay is deterministic whatever the order in
+* which requests are issued. Responses come back after the recorded latency, or from an idle
+* source as fast as possible. Only the latencies are reproduced : requests go out when the
+* application issues them, so the times at which they were recorded are not kept.
+*/
+
+#define _GEOCODER_TRACE_MAGIC	"GEOT"
+#define _GEOCODER_TRACE_VERSION	2
+#define _GEOCODER_TRACE_NULL	0xffff
+#define _GEOCODER_TRACE_NO_ACCURACY	0xff
+
+typedef enum {
+	__TRACE_ADDRESS = 1,
+	__TRACE_POSITION = 2
+}__trace_kind;
+
+typedef struct {
+	__trace_kind kind;
+	LocationError error;
+	guint latency;
+	LocationAddress *address;
+	LocationAccuracy *accuracy;
+	GList *positions;
+	GList *accuracies;
+}__trace_record;
+
+/* Records of one request key, in recording order */
+typedef struct {
+	GPtrArray *records;
+	guint next;
+}__trace_key;
+
+struct _geocoder_trace_s{
+	geocoder_trace_mode_e mode;
+	FILE *file;		/* record */
+	GHashTable *keys;	/* replay : request key -> __trace_key */
+	GList *pending;		/* replay : __trace_pending, scheduled responses */
+};
+
+/* A scheduled response, answered early when the trace is closed before it fires */
+typedef struct {
+	geocoder_trace_s *trace;
+	guint source;
+	__trace_record response;
+	LocationAddressCB address_cb;
+	LocationPositionCB position_cb;
+	gpointer userdata;
+}__trace_pending;
+
+G_LOCK_DEFINE_STATIC(trace);
+
+static gchar* __address_request_key(double latitude, double longitude)
+{
+	return g_strdup_printf("a%.7f,%.7f", latitude, longitude);
+}
+
+static gchar* __position_request_key(const char *address)
+{
+	return g_strconcat("p", address, NULL);
+}
+
+/*
+* Record
+*/
+static void __put(GString *buffer, const void *data, gsize size)
+{
+	g_string_append_len(buffer, data, size);
+}
+
+static void __put_u8(GString *buffer, guint8 value)
+{
+	__put(buffer, &value, sizeof(value));
+}
+
+static void __put_u16(GString *buffer, guint16 value)
+{
+	__put(buffer, &value, sizeof(value));
+}
+
+static void __put_u32(GString *buffer, guint32 value)
+{
+	__put(buffer, &value, sizeof(value));
+}
+
+static void __put_f64(GString *buffer, double value)
+{
+	__put(buffer, &value, sizeof(value));
+}
+
+static void __put_string(GString *buffer, const char *str)
+{
+	gsize len = str != NULL ? MIN(strlen(str), _GEOCODER_TRACE_NULL - 1) : 0;
+	__put_u16(buffer, str != NULL ? len : _GEOCODER_TRACE_NULL);
+	__put(buffer, str, len);
+}
+
+static void __put_accuracy(GString *buffer, const LocationAccuracy *accuracy)
+{
+	__put_u8(buffer, accuracy != NULL ? accuracy->level : _GEOCODER_TRACE_NO_ACCURACY);
+	__put_f64(buffer, accuracy != NULL ? accuracy->horizontal_accuracy : 0);
+	__put_f64(buffer, accuracy != NULL ? accuracy->vertical_accuracy : 0);
+}
+
+static GString* __record_begin(__trace_kind kind, LocationError error, gint64 issued)
+{
+	gint64 now = g_get_monotonic_time();
+	GString *buffer = g_string_sized_new(128);
+
+	__put_u8(buffer, kind);
+	__put_u32(buffer, error);
+	__put_u32(buffer, (guint32)(MAX(now - issued, 0) / 1000));
+	return buffer;
+}
+
+static void __record_end(geocoder_trace_s *trace, GString *buffer)
+{
+	G_LOCK(trace);
+	/* Flushed per record, so that a trace survives the process being killed */
+	if(fwrite(buffer->str, 1, buffer->len, trace->file) != buffer->len || fflush(trace->file) != 0)
+		LOGE("[%s] fail to write the trace", __FUNCTION__);
+	G_UNLOCK(trace);
+	g_string_free(buffer, TRUE);
+}
+
+void _geocoder_trace_record_address(geocoder_trace_s *trace, gint64 issued, double latitude, double longitude, LocationError error, const LocationAddress *addr, const LocationAccuracy *acc)
+{
+	if(trace->mode != GEOCODER_TRACE_RECORD)
+		return;
+
+	GString *buffer = __record_begin(__TRACE_ADDRESS, error, issued);
+	__put_f64(buffer, latitude);
+	__put_f64(buffer, longitude);
+	__put_string(buffer, addr != NULL ? addr->building_number : NULL);
+	__put_string(buffer, addr != NULL ? addr->postal_code : NULL);
+	__put_string(buffer, addr != NULL ? addr->street : NULL);
+	__put_string(buffer, addr != NULL ? addr->city : NULL);
+	__put_string(buffer, addr != NULL ? addr->district : NULL);
+	__put_string(buffer, addr != NULL ? addr->state : NULL);
+	__put_string(buffer, addr != NULL ? addr->country_code : NULL);
+	__put_accuracy(buffer, acc);
+	__record_end(trace, buffer);
+}
+
+void _geocoder_trace_record_position(geocoder_trace_s *trace, gint64 issued, const char *address, LocationError error, GList *position_list, GList *accuracy_list)
+{
+	if(trace->mode != GEOCODER_TRACE_RECORD)
+		return;
+
+	GString *buffer = __record_begin(__TRACE_POSITION, error, issued);
+	GList *iter;
+
+	__put_string(buffer, address);
+	__put_u16(buffer, MIN(g_list_length(position_list), G_MAXUINT16));
+	for(iter = position_list; iter != NULL; iter = g_list_next(iter))
+	{
+		LocationPosition *pos = iter->data;
+		__put_u32(buffer, pos->timestamp);
+		__put_f64(buffer, pos->latitude);
+		__put_f64(buffer, pos->longitude);
+		__put_f64(buffer, pos->altitude);
+		__put_u8(buffer, pos->status);
+	}
+	__put_u16(buffer, MIN(g_list_length(accuracy_list), G_MAXUINT16));
+	for(iter = accuracy_list; iter != NULL; iter = g_list_next(iter))
+		__put_accuracy(buffer, iter->data);
+	__record_end(trace, buffer);
+}
+
+/*
+* Load
+*/
+typedef struct {
+	const guint8 *data;
+	gsize size;
+	gsize offset;
+	bool failed;
+}__reader;
+
+static void __get(__reader *reader, void *out, gsize size)
+{
+	if(reader->failed || reader->offset + size > reader->size)
+	{
+		reader->failed = true;
+		memset(out, 0, size);
+		return;
+	}
+	memcpy(out, reader->data + reader->offset, size);
+	reader->offset += size;
+}
+
+static guint8 __get_u8(__reader *reader)
+{
+	guint8 value;
+	__get(reader, &value, sizeof(value));
+	return value;
+}
+
+static guint16 __get_u16(__reader *reader)
+{
+	guint16 value;
+	__get(reader, &value, sizeof(value));
+	return value;
+}
+
+static guint32 __get_u32(__reader *reader)
+{
+	guint32 value;
+	__get(reader, &value, sizeof(value));
+	return value;
+}
+
+static double __get_f64(__reader *reader)
+{
+	double value;
+	__get(reader, &value, sizeof(value));
+	return value;
+}
+
+static gchar* __get_string(__reader *reader)
+{
+	guint16 len = __get_u16(reader);
+	if(reader->failed || len == _GEOCODER_TRACE_NULL)
+		return NULL;
+	if(reader->offset + len > reader->size)
+	{
+		reader->failed = true;
+		return NULL;
+	}
+	gchar *str = g_strndup((const gchar*)reader->data + reader->offset, len);
+	reader->offset += len;
+	return str;
+}
+
+static LocationAccuracy* __get_accuracy(__reader *reader)
+{
+	guint8 level = __get_u8(reader);
+	double horizontal = __get_f64(reader);
+	double vertical = __get_f64(reader);
+	if(reader->failed || level == _GEOCODER_TRACE_NO_ACCURACY)
+		return NULL;
+	return location_accuracy_new(level, horizontal, vertical);
+}
+
+static void __record_clear(__trace_record *record)
+{
+	if(record->address != NULL)
+		location_address_free(record->address);
+	if(record->accuracy != NULL)
+		location_accuracy_free(record->accuracy);
+	g_list_free_full(record->positions, (GDestroyNotify)location_position_free);
+	g_list_free_full(record->accuracies, (GDestroyNotify)location_accuracy_free);
+}
+
+static void __record_free(gpointer data)
+{
+	__record_clear(data);
+	g_free(data);
+}
+
+static void __key_free(gpointer data)
+{
+	__trace_key *key = data;
+	g_ptr_array_free(key->records, TRUE);
+	g_free(key);
+}
+
+static __trace_record* __read_record(__reader *reader, gchar **request_key)
+{
+	__trace_record *record = g_new0(__trace_record, 1);
+	guint count;
+	guint i;
+
+	record->kind = __get_u8(reader);
+	record->error = __get_u32(reader);
+	record->latency = __get_u32(reader);
+
+	if(record->kind == __TRACE_ADDRESS)
+	{
+		double latitude = __get_f64(reader);
+		double longitude = __get_f64(reader);
+		gchar *fields[7];
+		for(i = 0; i < 7; i++)
+			fields[i] = __get_string(reader);
+		/* location_address_new() takes building number, street, district, city, state, country code, postal code */
+		if(fields[0] || fields[1] || fields[2] || fields[3] || fields[4] || fields[5] || fields[6])
+			record->address = location_address_new(fields[0], fields[2], fields[4], fields[3], fields[5], fields[6], fields[1]);
+		for(i = 0; i < 7; i++)
+			g_free(fields[i]);
+		record->accuracy = __get_accuracy(reader);
+		*request_key = __address_request_key(latitude, longitude);
+	}
+	else if(record->kind == __TRACE_POSITION)
+	{
+		gchar *address = __get_string(reader);
+		count = __get_u16(reader);
+		for(i = 0; i < count && !reader->failed; i++)
+		{
+			guint32 timestamp = __get_u32(reader);
+			double latitude = __get_f64(reader);
+			double longitude = __get_f64(reader);
+			double altitude = __get_f64(reader);
+			guint8 status = __get_u8(reader);
+			record->positions = g_list_append(record->positions, location_position_new(timestamp, latitude, longitude, altitude, status));
+		}
+		count = __get_u16(reader);
+		for(i = 0; i < count && !reader->failed; i++)
+		{
+			LocationAccuracy *accuracy = __get_accuracy(reader);
+			if(accuracy != NULL)
+				record->accuracies = g_list_append(record->accuracies, accuracy);
+		}
+		*request_key = address != NULL ? __position_request_key(address) : NULL;
+		g_free(address);
+	}
+	else
+	{
+		reader->failed = true;
+	}
+
+	if(reader->failed || *request_key == NULL)
+	{
+		g_free(*request_key);
+		__record_free(record);
+		return NULL;
+	}
+	return record;
+}
+
+static int __load(geocoder_trace_s *trace, const char *path)
+{
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+	__reader reader;
+	int count = 0;
+
+	if(!g_file_get_contents(path, &contents, &length, &error))
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to read %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		g_error_free(error);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	reader.data = (const guint8*)contents;
+	reader.size = length;
+	reader.offset = 4;
+	reader.failed = false;
+	if(length < 8 || memcmp(contents, _GEOCODER_TRACE_MAGIC, 4) != 0 || __get_u32(&reader) != _GEOCODER_TRACE_VERSION)
+	{
+		LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : %s is not a trace", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+		g_free(contents);
+		return GEOCODER_ERROR_INVALID_PARAMETER;
+	}
+
+	trace->keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, __key_free);
+	while(reader.offset < reader.size)
+	{
+		gchar *request_key = NULL;
+		__trace_record *record = __read_record(&reader, &request_key);
+		if(record == NULL)
+		{
+			/* A trace cut short by a killed recorder ends with a partial record */
+			LOGI("[%s] truncated record at %u", __FUNCTION__, (unsigned int)reader.offset);
+			break;
+		}
+		__trace_key *key = g_hash_table_lookup(trace->keys, request_key);
+		if(key == NULL)
+		{
+			key = g_new0(__trace_key, 1);
+			key->records = g_ptr_array_new_with_free_func(__record_free);
+			g_hash_table_insert(trace->keys, request_key, key);
+		}
+		else
+		{
+			g_free(request_key);
+		}
+		g_ptr_array_add(key->records, record);
+		count++;
+	}
+	g_free(contents);
+	LOGI("[%s] %d records, %u requests", __FUNCTION__, count, g_hash_table_size(trace->keys));
+	return GEOCODER_ERROR_NONE;
+}
+
+/*
+* Replay
+*/
+static void __answer(__trace_pending *pending)
+{
+	if(pending->response.kind == __TRACE_ADDRESS)
+		pending->address_cb(pending->response.error, pending->response.address, pending->response.accuracy, pending->userdata);
+	else
+		pending->position_cb(pending->response.error, pending->response.positions, pending->response.accuracies, pending->userdata);
+	__record_clear(&pending->response);
+	g_free(pending);
+}
+
+static gboolean __fire(gpointer data)
+{
+	__trace_pending *pending = data;
+
+	_geocoder_request_lock();
+	/* Unless closing the trace answered it while this waited for the lock */
+	if(!g_source_is_destroyed(g_main_current_source()))
+	{
+		pending->trace->pending = g_list_remove(pending->trace->pending, pending);
+		__answer(pending);
+	}
+	_geocoder_request_unlock();
+	return FALSE;
+}
+
+static int __replay(geocoder_trace_s *trace, const gchar *request_key, LocationAddressCB address_cb, LocationPositionCB position_cb, gpointer userdata)
+{
+	__trace_key *key = g_hash_table_lookup(trace->keys, request_key);
+	__trace_record *record;
+	__trace_pending *pending;
+	GList *iter;
+
+	if(key == NULL)
+	{
+		LOGI("[%s] no record for %s", __FUNCTION__, request_key);
+		return LOCATION_ERROR_NOT_FOUND;
+	}
+	record = g_ptr_array_index(key->records, MIN(key->next, key->records->len - 1));
+	key->next++;
+
+	pending = g_new0(__trace_pending, 1);
+	pending->trace = trace;
+	pending->response.kind = record->kind;
+	pending->response.error = record->error;
+	if(record->address != NULL)
+		pending->response.address = location_address_copy(record->address);
+	if(record->accuracy != NULL)
+		pending->response.accuracy = location_accuracy_copy(record->accuracy);
+	for(iter = record->positions; iter != NULL; iter = g_list_next(iter))
+		pending->response.positions = g_list_append(pending->response.positions, location_position_copy(iter->data));
+	for(iter = record->accuracies; iter != NULL; iter = g_list_next(iter))
+		pending->response.accuracies = g_list_append(pending->response.accuracies, location_accuracy_copy(iter->data));
+	pending->address_cb = address_cb;
+	pending->position_cb = position_cb;
+	pending->userdata = userdata;
+
+	if(trace->mode == GEOCODER_TRACE_REPLAY_FAST)
+		pending->source = g_idle_add(__fire, pending);
+	else
+		pending->source = g_timeout_add(record->latency, __fire, pending);
+	trace->pending = g_list_prepend(trace->pending, pending);
+	return LOCATION_ERROR_NONE;
+}
+
+bool _geocoder_trace_replaying(geocoder_trace_s *trace)
+{
+	return trace != NULL && (trace->mode == GEOCODER_TRACE_REPLAY || trace->mode == GEOCODER_TRACE_REPLAY_FAST);
+}
+
+int _geocoder_trace_replay_address(geocoder_trace_s *trace, double latitude, double longitude, LocationAddressCB callback, gpointer userdata)
+{
+	gchar *request_key = __address_request_key(latitude, longitude);
+	int ret = __replay(trace, request_key, callback, NULL, userdata);
+	g_free(request_key);
+	return ret;
+}
+
+int _geocoder_trace_replay_position(geocoder_trace_s *trace, const char *address, LocationPositionCB callback, gpointer userdata)
+{
+	gchar *request_key = __position_request_key(address);
+	int ret = __replay(trace, request_key, NULL, callback, userdata);
+	g_free(request_key);
+	return ret;
+}
+
+/*
+* Open, close
+*/
+int _geocoder_trace_open(geocoder_trace_mode_e mode, const char *path, geocoder_trace_s **trace)
+{
+	geocoder_trace_s *opened = g_new0(geocoder_trace_s, 1);
+	opened->mode = mode;
+
+	if(mode == GEOCODER_TRACE_RECORD)
+	{
+		guint32 version = _GEOCODER_TRACE_VERSION;
+		opened->file = fopen(path, "wb");
+		if(opened->file == NULL
+			|| fwrite(_GEOCODER_TRACE_MAGIC, 1, 4, opened->file) != 4
+			|| fwrite(&version, sizeof(version), 1, opened->file) != 1)
+		{
+			LOGE("[%s] GEOCODER_ERROR_INVALID_PARAMETER(0x%08x) : fail to create %s", __FUNCTION__, GEOCODER_ERROR_INVALID_PARAMETER, path);
+			_geocoder_trace_close(opened);
+			return GEOCODER_ERROR_INVALID_PARAMETER;
+		}
+	}
+	else
+	{
+		int ret = __load(opened, path);
+		if(ret != GEOCODER_ERROR_NONE)
+		{
+			_geocoder_trace_close(opened);
+			return ret;
+		}
+	}
+	*trace = opened;
+	return GEOCODER_ERROR_NONE;
+}
+
+void _geocoder_trace_close(geocoder_trace_s *trace)
+{
+	if(trace == NULL)
+		return;
+	/* Without their responses the requests would never complete, so they get them now, in the order they were asked */
+	trace->pending = g_list_reverse(trace->pending);
+	while(trace->pending != NULL)
+	{
+		__trace_pending *pending = trace->pending->data;
+		trace->pending = g_list_delete_link(trace->pending, trace->pending);
+		g_source_remove(pending->source);
+		__answer(pending);
+	}
+	if(trace->file != NULL)
+		fclose(trace->file);
+	if(trace->keys != NULL)
+		g_hash_table_destroy(trace->keys);
+	g_free(trace);
+}
@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/* Builds as C++20 with the library, so that geocoder.hpp is compiled and every awaitable instantiated */
+
+#include <stdio.h>
+#include <array>
+#include <coroutine>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include <glib.h>
+#include <geocoder.hpp>
+
+using namespace tizen::location;
+
+static GMainLoop *loop = NULL;
+
+/* The frame comes from the pool, like the results */
+static geocoder::task geocoder_hpp_test(std::allocator_arg_t, std::pmr::polymorphic_allocator<>, geocoder &coder)
+{
+	address one = co_await coder.reverse(37.258, 127.056);
+	printf("reverse() ===> result: %d, city: %s, country code: %s\n", one.result, one.city.c_str(), one.country_code.c_str());
+
+	positions found = co_await coder.forward("suwon");
+	printf("forward() ===> result: %d, count: %zu\n", found.result, found.items.size());
+
+	const std::array<position, 2> points = {{ {37.258, 127.056}, {37.5665, 126.978} }};
+	std::pmr::vector<address> addresses;
+	co_await coder.reverse_all(points, addresses);
+	for (const address &a : addresses)
+		printf("reverse_all() ===> result: %d, city: %s, country code: %s\n", a.result, a.city.c_str(), a.country_code.c_str());
+
+	const std::array<std::string_view, 2> queries = {{ "suwon", "seoul" }};
+	std::pmr::vector<positions> all;
+	co_await coder.forward_all(queries, all);
+	for (const positions &p : all)
+		printf("forward_all() ===> result: %d, count: %zu\n", p.result, p.items.size());
+
+	g_main_loop_quit(loop);
+}
+
+static gboolean exit_program (gpointer data)
+{
+	g_main_loop_quit (loop);
+	printf("Quit g_main_loop\n");
+	return FALSE;
+}
+
+int main(int argc, char ** argv)
+{
+	loop = g_main_loop_new (NULL, TRUE);
+	g_setenv("PKG_NAME", "org.tizen.capi-location-geocoder-test", 1);
+
+	try {
+		std::pmr::unsynchronized_pool_resource pool;
+		geocoder coder(&pool);
+		geocoder_hpp_test(std::allocator_arg, &pool, coder);
+		g_timeout_add_seconds(30, exit_program, NULL);
+		g_main_loop_run (loop);
+	} catch (const geocoder_error &e) {
+		printf ("geocoder_create return error : %d\n", e.code());
+	}
+	return 0;
+}
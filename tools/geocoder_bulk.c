@@ -0,0 +1,718 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+* geocoder-bulk : streams coordinates or addresses through the geocoder
+*
+* Input is read line by line from a file (mmap'd) or stdin, as CSV or JSONL.
+* At most <window> requests are in flight, and results are written in input order,
+* so memory stays bounded by the window whatever the size of the input.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <geocoder.h>
+
+#define DEFAULT_WINDOW			32
+#define MAX_WINDOW		4096
+#define CHECKPOINT_INTERVAL		1000	/* rows */
+
+typedef enum {
+	MODE_REVERSE,
+	MODE_FORWARD,
+} bulk_mode_e;
+
+typedef enum {
+	FORMAT_CSV,
+	FORMAT_JSONL,
+} bulk_format_e;
+
+typedef struct {
+	bool done;
+	gint64 next_offset;	/* input offset of the row following this one */
+	gchar *input;
+	GString *output;
+} bulk_slot_s;
+
+typedef struct {
+	geocoder_h geocoder;
+	GMainLoop *loop;
+	bulk_mode_e mode;
+	bulk_format_e format;
+
+	/* input : either a mapped file or a stream */
+	const char *map;
+	gsize map_size;
+	FILE *in;
+	gint64 offset;
+	bool eof;
+
+	FILE *out;
+	const char *checkpoint_path;
+
+	int window;
+	bulk_slot_s *slots;
+	gint64 next_issue;
+	gint64 next_write;
+	int in_flight;
+	guint idle_id;
+	gint64 errors;
+} bulk_s;
+
+typedef struct {
+	bulk_s *bulk;
+	bulk_slot_s *slot;
+} bulk_request_s;
+
+/*
+* Input
+*/
+static gchar* read_line(bulk_s *bulk)
+{
+	if(bulk->map != NULL)
+	{
+		if(bulk->offset >= (gint64)bulk->map_size)
+			return NULL;
+		const char *start = bulk->map + bulk->offset;
+		const char *end = memchr(start, '\n', bulk->map_size - bulk->offset);
+		gsize len = end ? (gsize)(end - start) : bulk->map_size - bulk->offset;
+		bulk->offset += len + (end ? 1 : 0);
+		return g_strndup(start, len);
+	}
+
+	char *line = NULL;
+	size_t cap = 0;
+	ssize_t len = getline(&line, &cap, bulk->in);
+	if(len < 0)
+	{
+		free(line);
+		return NULL;
+	}
+	bulk->offset += len;
+	gchar *ret = g_strndup(line, len);
+	free(line);
+	return ret;
+}
+
+static gchar* json_string_value(const char *line, const char *key)
+{
+	gchar *pattern = g_strdup_printf("\"%s\"", key);
+	const char *p = strstr(line, pattern);
+	g_free(pattern);
+	if(p == NULL)
+		return NULL;
+	p = strchr(p + strlen(key) + 2, ':');
+	if(p == NULL)
+		return NULL;
+	while(*++p == ' ' || *p == '\t');
+	if(*p != '"')
+		return NULL;
+
+	GString *value = g_string_new(NULL);
+	for(p++; *p && *p != '"'; p++)
+	{
+		if(*p == '\\' && p[1])
+		{
+			p++;
+			switch(*p)
+			{
+				case 'n': g_string_append_c(value, '\n'); break;
+				case 't': g_string_append_c(value, '\t'); break;
+				default: g_string_append_c(value, *p); break;
+			}
+			continue;
+		}
+		g_string_append_c(value, *p);
+	}
+	return g_string_free(value, FALSE);
+}
+
+static bool json_number_value(const char *line, const char *key, double *value)
+{
+	gchar *pattern = g_strdup_printf("\"%s\"", key);
+	const char *p = strstr(line, pattern);
+	g_free(pattern);
+	if(p == NULL)
+		return false;
+	p = strchr(p + strlen(key) + 2, ':');
+	if(p == NULL)
+		return false;
+
+	char *end = NULL;
+	*value = g_ascii_strtod(p + 1, &end);
+	return end != p + 1;
+}
+
+static bool parse_position(bulk_s *bulk, const char *line, double *latitude, double *longitude)
+{
+	if(bulk->format == FORMAT_JSONL)
+	{
+		return (json_number_value(line, "latitude", latitude) || json_number_value(line, "lat", latitude))
+			&& (json_number_value(line, "longitude", longitude) || json_number_value(line, "lon", longitude));
+	}
+
+	char *end = NULL;
+	*latitude = g_ascii_strtod(line, &end);
+	if(end == line || *end != ',')
+		return false;
+	const char *next = end + 1;
+	*longitude = g_ascii_strtod(next, &end);
+	return end != next;
+}
+
+static gchar* parse_address(bulk_s *bulk, const char *line)
+{
+	if(bulk->format == FORMAT_JSONL)
+		return json_string_value(line, "address");
+
+	/* A quoted first field, or else the whole line : addresses contain commas */
+	if(line[0] != '"')
+		return g_strdup(line);
+
+	GString *value = g_string_new(NULL);
+	const char *p;
+	for(p = line + 1; *p; p++)
+	{
+		if(*p == '"')
+		{
+			if(p[1] != '"')
+				break;
+			p++;
+		}
+		g_string_append_c(value, *p);
+	}
+	return g_string_free(value, FALSE);
+}
+
+/*
+* Output
+*/
+static void append_field(bulk_s *bulk, GString *out, const char *value, bool first)
+{
+	const char *p;
+
+	if(bulk->format == FORMAT_CSV)
+	{
+		if(!first)
+			g_string_append_c(out, ',');
+		if(value == NULL)
+			return;
+		if(strpbrk(value, ",\"\n") == NULL)
+		{
+			g_string_append(out, value);
+			return;
+		}
+		g_string_append_c(out, '"');
+		for(p = value; *p; p++)
+		{
+			if(*p == '"')
+				g_string_append_c(out, '"');
+			g_string_append_c(out, *p);
+		}
+		g_string_append_c(out, '"');
+		return;
+	}
+
+	if(value == NULL)
+	{
+		g_string_append(out, "null");
+		return;
+	}
+	g_string_append_c(out, '"');
+	for(p = value; *p; p++)
+	{
+		switch(*p)
+		{
+			case '"': g_string_append(out, "\\\""); break;
+			case '\\': g_string_append(out, "\\\\"); break;
+			case '\n': g_string_append(out, "\\n"); break;
+			case '\t': g_string_append(out, "\\t"); break;
+			default:
+				if((unsigned char)*p < 0x20)
+					g_string_append_printf(out, "\\u%04x", *p);
+				else
+					g_string_append_c(out, *p);
+		}
+	}
+	g_string_append_c(out, '"');
+}
+
+static void append_key(bulk_s *bulk, GString *out, const char *key, bool first)
+{
+	if(bulk->format == FORMAT_JSONL)
+		g_string_append_printf(out, "%s\"%s\":", first ? "{" : ",", key);
+}
+
+static gboolean pump(gpointer user_data);
+
+static void schedule_pump(bulk_s *bulk)
+{
+	if(bulk->idle_id == 0)
+		bulk->idle_id = g_idle_add(pump, bulk);
+}
+
+static void finish_slot(bulk_s *bulk, bulk_slot_s *slot, int result)
+{
+	if(result != GEOCODER_ERROR_NONE)
+		bulk->errors++;
+	slot->done = true;
+	bulk->in_flight--;
+	schedule_pump(bulk);
+}
+
+static void get_addr_cb(geocoder_error_e result, const char *building_number, const char *postal_code, const char *street, const  char *city, const char *district, const char *state, const char *country_code, void *user_data)
+{
+	bulk_request_s *request = user_data;
+	bulk_s *bulk = request->bulk;
+	GString *out = request->slot->output;
+	const char *fields[] = { building_number, postal_code, street, city, district, state, country_code };
+	const char *keys[] = { "building_number", "postal_code", "street", "city", "district", "state", "country_code" };
+	int i;
+
+	g_string_append_printf(out, bulk->format == FORMAT_CSV ? ",%d" : ",\"result\":%d", result);
+	for(i = 0; i < (int)G_N_ELEMENTS(fields); i++)
+	{
+		append_key(bulk, out, keys[i], false);
+		append_field(bulk, out, result == GEOCODER_ERROR_NONE ? fields[i] : NULL, false);
+	}
+	if(bulk->format == FORMAT_JSONL)
+		g_string_append_c(out, '}');
+	g_string_append_c(out, '\n');
+
+	finish_slot(bulk, request->slot, result);
+	g_free(request);
+}
+
+static void get_positions_cb(geocoder_error_e result, int count, const double *latitudes, const double *longitudes, void *user_data)
+{
+	bulk_request_s *request = user_data;
+	bulk_s *bulk = request->bulk;
+	GString *out = request->slot->output;
+	int i;
+
+	if(bulk->format == FORMAT_CSV)
+	{
+		g_string_append_printf(out, ",%d,", result);
+		for(i = 0; result == GEOCODER_ERROR_NONE && i < count; i++)
+			g_string_append_printf(out, "%s%.7f %.7f", i ? ";" : "", latitudes[i], longitudes[i]);
+		g_string_append_c(out, '\n');
+	}
+	else
+	{
+		g_string_append_printf(out, ",\"result\":%d,\"positions\":[", result);
+		for(i = 0; result == GEOCODER_ERROR_NONE && i < count; i++)
+			g_string_append_printf(out, "%s{\"latitude\":%.7f,\"longitude\":%.7f}", i ? "," : "", latitudes[i], longitudes[i]);
+		g_string_append(out, "]}\n");
+	}
+
+	finish_slot(bulk, request->slot, result);
+	g_free(request);
+}
+
+/*
+* Checkpoint : "<rows written> <input offset> <output offset>"
+*
+* The output up to the offset and the checkpoint itself reach the disk before the checkpoint replaces
+* the previous one, so a crash leaves either checkpoint, each consistent with the output.
+*/
+static bool sync_directory(const char *path)
+{
+	gchar *dir = g_path_get_dirname(path);
+	int fd = open(dir, O_RDONLY | O_DIRECTORY);
+	bool ok = fd >= 0 && fsync(fd) == 0;
+
+	if(fd >= 0)
+		close(fd);
+	g_free(dir);
+	return ok;
+}
+
+static void write_checkpoint(bulk_s *bulk, gint64 input_offset)
+{
+	if(bulk->checkpoint_path == NULL)
+		return;
+
+	if(fflush(bulk->out) != 0 || fsync(fileno(bulk->out)) != 0)
+	{
+		fprintf(stderr, "geocoder-bulk: fail to sync output : %s\n", strerror(errno));
+		return;
+	}
+	off_t output_offset = ftello(bulk->out);
+	if(output_offset < 0)
+	{
+		fprintf(stderr, "geocoder-bulk: fail to locate output : %s\n", strerror(errno));
+		return;
+	}
+	gchar *tmp = g_strdup_printf("%s.tmp", bulk->checkpoint_path);
+	FILE *fp = fopen(tmp, "w");
+	if(fp != NULL)
+	{
+		fprintf(fp, "%lld %lld %lld\n", (long long)bulk->next_write, (long long)input_offset, (long long)output_offset);
+		bool synced = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+		if(fclose(fp) == 0 && synced && sync_directory(tmp) && rename(tmp, bulk->checkpoint_path) == 0 && sync_directory(bulk->checkpoint_path))
+		{
+			g_free(tmp);
+			return;
+		}
+	}
+	fprintf(stderr, "geocoder-bulk: fail to write checkpoint %s : %s\n", bulk->checkpoint_path, strerror(errno));
+	g_free(tmp);
+}
+
+static bool resume_checkpoint(bulk_s *bulk)
+{
+	long long rows = 0, input_offset = 0, output_offset = 0;
+	FILE *fp = fopen(bulk->checkpoint_path, "r");
+
+	if(fp == NULL)
+	{
+		/* Fresh start */
+		return errno == ENOENT && ftruncate(fileno(bulk->out), 0) == 0;
+	}
+	int n = fscanf(fp, "%lld %lld %lld", &rows, &input_offset, &output_offset);
+	fclose(fp);
+	if(n != 3)
+		return false;
+
+	/* Drop whatever was written after the checkpoint */
+	if(ftruncate(fileno(bulk->out), (off_t)output_offset) != 0 || fseeko(bulk->out, (off_t)output_offset, SEEK_SET) != 0)
+		return false;
+
+	if(bulk->map != NULL)
+	{
+		bulk->offset = input_offset;
+	}
+	else if(fseeko(bulk->in, (off_t)input_offset, SEEK_SET) == 0)
+	{
+		bulk->offset = input_offset;
+	}
+	else
+	{
+		/* Not seekable (pipe) : read past the rows already done */
+		gchar *line;
+		while(bulk->offset < input_offset && (line = read_line(bulk)) != NULL)
+			g_free(line);
+	}
+	bulk->next_issue = bulk->next_write = rows;
+	fprintf(stderr, "geocoder-bulk: resuming at row %lld\n", rows);
+	return true;
+}
+
+/*
+* Pipeline
+*/
+static void flush_slots(bulk_s *bulk)
+{
+	while(bulk->next_write < bulk->next_issue)
+	{
+		bulk_slot_s *slot = &bulk->slots[bulk->next_write % bulk->window];
+		if(!slot->done)
+			break;
+		fwrite(slot->output->str, 1, slot->output->len, bulk->out);
+		g_string_truncate(slot->output, 0);
+		g_free(slot->input);
+		slot->input = NULL;
+		slot->done = false;
+		bulk->next_write++;
+		if(bulk->next_write % CHECKPOINT_INTERVAL == 0)
+			write_checkpoint(bulk, slot->next_offset);
+	}
+}
+
+static void issue(bulk_s *bulk, bulk_slot_s *slot)
+{
+	bulk_request_s *request = g_new0(bulk_request_s, 1);
+	GString *out = slot->output;
+	double latitude, longitude;
+	int ret = GEOCODER_ERROR_INVALID_PARAMETER;
+	gchar *address = NULL;
+
+	request->bulk = bulk;
+	request->slot = slot;
+	bulk->in_flight++;
+
+	if(bulk->mode == MODE_REVERSE && parse_position(bulk, slot->input, &latitude, &longitude))
+	{
+		if(bulk->format == FORMAT_CSV)
+			g_string_printf(out, "%.7f,%.7f", latitude, longitude);
+		else
+			g_string_printf(out, "{\"latitude\":%.7f,\"longitude\":%.7f", latitude, longitude);
+		ret = geocoder_get_address_from_position(bulk->geocoder, latitude, longitude, get_addr_cb, request);
+	}
+	else if(bulk->mode == MODE_FORWARD && (address = parse_address(bulk, slot->input)) != NULL)
+	{
+		g_string_truncate(out, 0);
+		append_key(bulk, out, "address", true);
+		append_field(bulk, out, address, true);
+		ret = geocoder_get_positions_from_address(bulk->geocoder, address, get_positions_cb, request);
+		g_free(address);
+	}
+	else
+	{
+		g_string_truncate(out, 0);
+		append_key(bulk, out, "input", true);
+		append_field(bulk, out, slot->input, true);
+	}
+
+	if(ret != GEOCODER_ERROR_NONE)
+	{
+		if(bulk->mode == MODE_REVERSE)
+			get_addr_cb(ret, NULL, NULL, NULL, NULL, NULL, NULL, NULL, request);
+		else
+			get_positions_cb(ret, 0, NULL, NULL, request);
+	}
+}
+
+static gboolean pump(gpointer user_data)
+{
+	bulk_s *bulk = user_data;
+
+	bulk->idle_id = 0;
+	flush_slots(bulk);
+	while(!bulk->eof && bulk->next_issue - bulk->next_write < bulk->window)
+	{
+		gchar *line = read_line(bulk);
+		if(line == NULL)
+		{
+			bulk->eof = true;
+			break;
+		}
+		g_strchomp(line);
+		if(line[0] == '\0')
+		{
+			g_free(line);
+			continue;
+		}
+
+		bulk_slot_s *slot = &bulk->slots[bulk->next_issue++ % bulk->window];
+		slot->done = false;
+		slot->input = line;
+		slot->next_offset = bulk->offset;
+		issue(bulk, slot);
+		flush_slots(bulk);
+	}
+
+	if(bulk->eof && bulk->in_flight == 0 && bulk->next_write == bulk->next_issue)
+	{
+		write_checkpoint(bulk, bulk->offset);
+		g_main_loop_quit(bulk->loop);
+	}
+	/* Completions schedule the next round */
+	return FALSE;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: geocoder-bulk [OPTION]... [INPUT]\n"
+		"Geocode every line of INPUT (or stdin) and write the results in input order.\n\n"
+		"  -m, --mode=reverse|forward   'lat,lon' rows to addresses (default), or addresses to positions\n"
+		"  -f, --format=csv|jsonl       input and output format (default csv)\n"
+		"  -w, --window=N               number of requests in flight, 1 to %d (default %d)\n"
+		"  -o, --output=FILE            write results to FILE instead of stdout\n"
+		"  -c, --checkpoint=FILE        record progress in FILE every %d rows, and resume from it\n"
+		"  -t, --trace=MODE:FILE        record the provider traffic to FILE, or replay FILE instead of the provider;\n"
+		"                               MODE is record, replay (recorded latencies) or replay-fast\n",
+		MAX_WINDOW, DEFAULT_WINDOW, CHECKPOINT_INTERVAL);
+}
+
+static const struct option options[] = {
+	{ "mode", required_argument, NULL, 'm' },
+	{ "format", required_argument, NULL, 'f' },
+	{ "window", required_argument, NULL, 'w' },
+	{ "output", required_argument, NULL, 'o' },
+	{ "checkpoint", required_argument, NULL, 'c' },
+	{ "trace", required_argument, NULL, 't' },
+	{ NULL, 0, NULL, 0 },
+};
+
+int main(int argc, char ** argv)
+{
+	bulk_s bulk;
+	const char *output_path = NULL;
+	const char *trace = NULL;
+	gint64 started;
+	int opt;
+	int i;
+
+	memset(&bulk, 0, sizeof(bulk));
+	bulk.window = DEFAULT_WINDOW;
+	bulk.in = stdin;
+	bulk.out = stdout;
+
+	while((opt = getopt_long(argc, argv, "m:f:w:o:c:t:", options, NULL)) != -1)
+	{
+		switch(opt)
+		{
+			case 'm':
+				if(strcmp(optarg, "reverse") == 0)
+					bulk.mode = MODE_REVERSE;
+				else if(strcmp(optarg, "forward") == 0)
+					bulk.mode = MODE_FORWARD;
+				else
+				{
+					fprintf(stderr, "geocoder-bulk: invalid mode %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'f':
+				if(strcmp(optarg, "csv") == 0)
+					bulk.format = FORMAT_CSV;
+				else if(strcmp(optarg, "jsonl") == 0)
+					bulk.format = FORMAT_JSONL;
+				else
+				{
+					fprintf(stderr, "geocoder-bulk: invalid format %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'w':
+			{
+				char *end;
+				long window;
+
+				errno = 0;
+				window = strtol(optarg, &end, 10);
+				if(errno != 0 || end == optarg || *end != '\0' || window < 1 || window > MAX_WINDOW)
+				{
+					fprintf(stderr, "geocoder-bulk: invalid window %s, expected 1 to %d\n", optarg, MAX_WINDOW);
+					return 1;
+				}
+				bulk.window = window;
+				break;
+			}
+			case 'o': output_path = optarg; break;
+			case 'c': bulk.checkpoint_path = optarg; break;
+			case 't': trace = optarg; break;
+			default:
+				usage();
+				return 1;
+		}
+	}
+	i = optind;
+
+	if(i < argc && strcmp(argv[i], "-") != 0)
+	{
+		int fd = open(argv[i], O_RDONLY);
+		struct stat st;
+		if(fd < 0 || fstat(fd, &st) != 0)
+		{
+			fprintf(stderr, "geocoder-bulk: %s : %s\n", argv[i], strerror(errno));
+			return 1;
+		}
+		if(st.st_size > 0)
+		{
+			bulk.map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(bulk.map == MAP_FAILED)
+			{
+				fprintf(stderr, "geocoder-bulk: fail to map %s : %s\n", argv[i], strerror(errno));
+				return 1;
+			}
+			madvise((void*)bulk.map, st.st_size, MADV_SEQUENTIAL);
+			bulk.map_size = st.st_size;
+		}
+		else
+		{
+			bulk.eof = true;
+		}
+		close(fd);
+	}
+
+	if(bulk.checkpoint_path != NULL && output_path == NULL)
+	{
+		fprintf(stderr, "geocoder-bulk: --checkpoint needs --output\n");
+		return 1;
+	}
+	if(output_path != NULL)
+	{
+		/* Keep the previous output when resuming, it is cut back to the checkpoint */
+		int fd = open(output_path, O_WRONLY | O_CREAT | (bulk.checkpoint_path ? 0 : O_TRUNC), 0644);
+		if(fd < 0 || (bulk.out = fdopen(fd, "w")) == NULL)
+		{
+			fprintf(stderr, "geocoder-bulk: %s : %s\n", output_path, strerror(errno));
+			return 1;
+		}
+		if(bulk.checkpoint_path != NULL)
+		{
+			if(!resume_checkpoint(&bulk))
+			{
+				fprintf(stderr, "geocoder-bulk: fail to resume from %s\n", bulk.checkpoint_path);
+				return 1;
+			}
+		}
+	}
+
+	if(geocoder_create(&bulk.geocoder) != GEOCODER_ERROR_NONE)
+	{
+		fprintf(stderr, "geocoder-bulk: fail to create geocoder\n");
+		return 1;
+	}
+
+	if(trace != NULL)
+	{
+		geocoder_trace_mode_e trace_mode = GEOCODER_TRACE_NONE;
+		const char *colon = strchr(trace, ':');
+		if(colon != NULL)
+		{
+			gchar *name = g_strndup(trace, colon - trace);
+			if(strcmp(name, "record") == 0)
+				trace_mode = GEOCODER_TRACE_RECORD;
+			else if(strcmp(name, "replay") == 0)
+				trace_mode = GEOCODER_TRACE_REPLAY;
+			else if(strcmp(name, "replay-fast") == 0)
+				trace_mode = GEOCODER_TRACE_REPLAY_FAST;
+			g_free(name);
+		}
+		if(trace_mode == GEOCODER_TRACE_NONE || geocoder_set_trace(bulk.geocoder, trace_mode, colon + 1) != GEOCODER_ERROR_NONE)
+		{
+			fprintf(stderr, "geocoder-bulk: invalid trace %s\n", trace);
+			geocoder_destroy(bulk.geocoder);
+			return 1;
+		}
+	}
+
+	bulk.slots = g_new0(bulk_slot_s, bulk.window);
+	for(i = 0; i < bulk.window; i++)
+		bulk.slots[i].output = g_string_sized_new(256);
+
+	bulk.loop = g_main_loop_new(NULL, FALSE);
+	started = g_get_monotonic_time();
+	schedule_pump(&bulk);
+	g_main_loop_run(bulk.loop);
+
+	fflush(bulk.out);
+	geocoder_destroy(bulk.geocoder);
+	for(i = 0; i < bulk.window; i++)
+		g_string_free(bulk.slots[i].output, TRUE);
+	g_free(bulk.slots);
+	g_main_loop_unref(bulk.loop);
+	if(bulk.map != NULL)
+		munmap((void*)bulk.map, bulk.map_size);
+	if(bulk.out != stdout)
+		fclose(bulk.out);
+
+	fprintf(stderr, "geocoder-bulk: %lld rows, %lld errors in %.3f s\n", (long long)bulk.next_write, (long long)bulk.errors,
+		(g_get_monotonic_time() - started) / 1e6);
+	return bulk.errors ? 2 : 0;
+}